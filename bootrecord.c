@@ -42,91 +42,2260 @@
 #include "bootrecord.h"
 #include <string.h>
 
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Default number of name table slots */
+#define BOOT_RECORD_DEFAULT_NAME_CAPACITY   (32U)
+
+/* Read the 32-bit counter inline if the config header provides it */
+#ifndef BOOT_RECORD_COUNTER
+#define BOOT_RECORD_COUNTER()               boot_record_get_counter()
+#else
+#define BOOT_RECORD_INLINE_COUNTER          (1)
+#endif
+
+/* boot_record_scrub has nothing left to clear */
+#define BOOT_RECORD_SCRUB_DONE              (0xFFFFFFFFU)
+
 /* ========================================================================== */
 /*                          Global Variables                                  */
 /* ========================================================================== */
 
 static boot_records_t gboot_records_config;
 
+#ifndef BOOT_RECORD_TIMESTAMP
+/* Half periods of boot_record_get_counter seen so far, its low bit matches
+ * the top bit of the counter */
+static uint32_t gboot_record_counter_halves;
+#endif
+
+/* Bounds of the site table, defined by the linker. Weak so that an image
+ * without sites still links, both are then NULL */
+extern const boot_record_site_t __start_bootrecord_sites[] __attribute__((weak));
+extern const boot_record_site_t __stop_bootrecord_sites[] __attribute__((weak));
+
 /* ========================================================================== */
 /*                          Function Definitions                              */
 /* ========================================================================== */
 
+/**
+ * Read the time source chosen at build time, inlined into the callers
+ */
+static inline uint64_t boot_record_now(void)
+{
+#ifdef BOOT_RECORD_TIMESTAMP
+    return BOOT_RECORD_TIMESTAMP();
+#else
+    uint32_t halves;
+    uint32_t seen;
+    uint32_t raw;
+
+#ifndef BOOT_RECORD_INLINE_COUNTER
+    if (boot_record_get_timestamp)
+    {
+        return boot_record_get_timestamp();
+    }
+#endif
+
+    /* Loaded before the counter is read, so the count is never ahead */
+    halves = __atomic_load_n(&gboot_record_counter_halves, __ATOMIC_ACQUIRE);
+    raw = BOOT_RECORD_COUNTER();
+
+    /* The counter entered the next half period since the last call */
+    if ((raw >> 31) != (halves & 1U))
+    {
+        seen = halves;
+        halves++;
+
+        /* Fails only if an interrupt or another core stored the same or a
+         * later count meanwhile, which leaves the result valid */
+        (void)__atomic_compare_exchange_n(&gboot_record_counter_halves, &seen,
+                                          halves, 0, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED);
+    }
+
+    return ((uint64_t)(halves >> 1) << 32) | raw;
+#endif
+}
+
+/**
+ * Get the current timestamp, as records are stamped with it
+ */
+uint64_t boot_record_timestamp(void)
+{
+    return boot_record_now();
+}
+
+/**
+ * Set boot record initialization parameters to their defaults
+ */
+void boot_record_params_init(boot_record_params_t *params)
+{
+    if (params)
+    {
+        memset(params, 0, sizeof(*params));
+        params->name_capacity = BOOT_RECORD_DEFAULT_NAME_CAPACITY;
+    }
+}
+
 /**
  * Initialize the boot records system
  */
 boot_record_status_t boot_record_init(uint32_t stage_id, void *memory_addr, uint32_t size)
 {
-    if (!memory_addr || size < (sizeof(boot_stage_record_t) +
-                             sizeof(boot_record_profile_t)))
+    return boot_record_ctx_init_ex(&gboot_records_config, stage_id,
+                                   memory_addr, size, NULL);
+}
+
+/**
+ * Initialize a boot record context
+ */
+boot_record_status_t boot_record_ctx_init(boot_records_t *ctx, uint32_t stage_id,
+                                         void *memory_addr, uint32_t size)
+{
+    return boot_record_ctx_init_ex(ctx, stage_id, memory_addr, size, NULL);
+}
+
+/**
+ * Size of one profile slot for the given stage flags
+ */
+static uint32_t boot_record_record_size(uint32_t flags)
+{
+    /* A stream is split into blocks, which take the place of slots */
+    if (flags & BOOT_RECORD_FLAG_STREAM)
+    {
+        return BOOT_RECORD_STREAM_BLOCK_SIZE;
+    }
+
+    if (flags & BOOT_RECORD_FLAG_COMPACT)
+    {
+        return (uint32_t)sizeof(boot_record_compact_profile_t);
+    }
+
+    return (flags & BOOT_RECORD_FLAG_NAME_IDS) ?
+           (uint32_t)sizeof(boot_record_id_profile_t) :
+           (uint32_t)sizeof(boot_record_profile_t);
+}
+
+/**
+ * Get the number of entries in the site table of the image
+ */
+static uint32_t boot_record_site_count(void)
+{
+    return (uint32_t)(__stop_bootrecord_sites - __start_bootrecord_sites);
+}
+
+/**
+ * Write the layout descriptor of a stage, after its flags and tick rate
+ */
+static void boot_record_set_format(boot_stage_record_t *stage)
+{
+    stage->version = BOOT_RECORD_FORMAT_VERSION;
+    stage->header_size = (uint16_t)sizeof(*stage);
+    stage->record_stride = (uint16_t)boot_record_record_size(stage->flags);
+    stage->name_len = BOOT_RECORD_NAME_LEN;
+    stage->time_unit = stage->tick_rate_hz ? BOOT_RECORD_TIME_TICKS :
+                                             BOOT_RECORD_TIME_US;
+    stage->byte_order = BOOT_RECORD_BYTE_ORDER;
+    stage->magic = BOOT_RECORD_MAGIC;
+}
+
+/**
+ * Get a per-CPU sub-stage for writing, the CPU index must be in range
+ */
+static boot_stage_record_t *boot_record_cpu_stage(boot_stage_record_t *stage,
+                                                  uint32_t cpu_id)
+{
+    return (boot_stage_record_t *)((uint8_t *)stage + stage->cpu_offset +
+                                   cpu_id * stage->cpu_stride);
+}
+
+/**
+ * Split a boot stage into cache-line-aligned per-CPU sub-stages
+ */
+static boot_record_status_t boot_record_split_cpus(boot_stage_record_t *stage,
+                                                   uint32_t size,
+                                                   uint32_t num_cpus)
+{
+    uint32_t record_size = boot_record_record_size(stage->flags);
+    uintptr_t base = (uintptr_t)stage;
+    uintptr_t first;
+    uint32_t stride;
+    uint32_t cpu;
+
+    first = (base + sizeof(*stage) + BOOT_RECORD_CACHE_LINE_SIZE - 1U) &
+            ~((uintptr_t)BOOT_RECORD_CACHE_LINE_SIZE - 1U);
+    if ((first - base) >= size)
+    {
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+
+    stride = ((size - (uint32_t)(first - base)) / num_cpus) &
+             ~(BOOT_RECORD_CACHE_LINE_SIZE - 1U);
+    if (stride < (sizeof(boot_stage_record_t) + record_size))
+    {
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+
+    stage->cpu_count = num_cpus;
+    stage->cpu_offset = (uint32_t)(first - base);
+    stage->cpu_stride = stride;
+
+    for (cpu = 0; cpu < num_cpus; cpu++)
+    {
+        boot_stage_record_t *sub = (boot_stage_record_t *)(first + cpu * stride);
+        uint32_t sub_offset = (uint32_t)((uintptr_t)sub - base);
+
+        /* Needed after a lazy init, which leaves the sub-stages untouched */
+        memset(sub, 0, sizeof(*sub));
+        sub->record_id = stage->record_id;
+        sub->flags = stage->flags & ~BOOT_RECORD_FLAG_PER_CPU;
+        sub->tick_rate_hz = stage->tick_rate_hz;
+        boot_record_set_format(sub);
+        sub->possible_records = (stride - sizeof(boot_stage_record_t)) /
+                                record_size;
+
+        /* All CPUs share the name table at the end of the region */
+        if (stage->name_offset)
+        {
+            sub->name_offset = stage->name_offset - sub_offset;
+        }
+        sub->name_capacity = stage->name_capacity;
+
+        stage->possible_records += sub->possible_records;
+    }
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Clear the commit markers of every slot of a stage
+ *
+ * A lazy init leaves old records in place; without this a reader could take
+ * a reserved but unwritten slot for a committed one.
+ */
+static void boot_record_clear_markers(boot_stage_record_t *stage)
+{
+    uint32_t i;
+
+    for (i = 0; i < stage->possible_records; i++)
+    {
+        if (stage->flags & BOOT_RECORD_FLAG_COMPACT)
+        {
+            ((boot_record_compact_profile_t *)stage->profiles)[i].data = 0;
+        }
+        else if (stage->flags & BOOT_RECORD_FLAG_NAME_IDS)
+        {
+            ((boot_record_id_profile_t *)stage->profiles)[i].info = 0;
+        }
+        else
+        {
+            stage->profiles[i].name[BOOT_RECORD_NAME_LEN - 1U] = '\0';
+        }
+    }
+}
+
+/**
+ * Initialize the boot records system with explicit parameters
+ */
+boot_record_status_t boot_record_init_ex(uint32_t stage_id, void *memory_addr,
+                                        uint32_t size,
+                                        const boot_record_params_t *params)
+{
+    return boot_record_ctx_init_ex(&gboot_records_config, stage_id,
+                                   memory_addr, size, params);
+}
+
+/**
+ * Initialize a boot record context with explicit parameters
+ */
+boot_record_status_t boot_record_ctx_init_ex(boot_records_t *ctx,
+                                            uint32_t stage_id,
+                                            void *memory_addr, uint32_t size,
+                                            const boot_record_params_t *params)
+{
+    boot_record_params_t defaults;
+    boot_record_status_t status;
+    uint32_t record_space = size;
+    uint32_t name_offset = 0;
+    uint32_t name_capacity = 0;
+
+    if (!ctx || !memory_addr || size < (sizeof(boot_stage_record_t) +
+                                        sizeof(boot_record_profile_t)))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if (!params)
+    {
+        boot_record_params_init(&defaults);
+        params = &defaults;
+    }
+
+    /* Overwriting slots is not supported with concurrent reservation */
+    if ((params->flags & BOOT_RECORD_FLAG_RING) &&
+        (params->flags & BOOT_RECORD_FLAG_CONCURRENT))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    /* Compact records have no room for an inline name */
+    if ((params->flags & BOOT_RECORD_FLAG_COMPACT) &&
+        !(params->flags & BOOT_RECORD_FLAG_NAME_IDS))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    /* A stream is appended by one writer and never overwritten */
+    if ((params->flags & BOOT_RECORD_FLAG_STREAM) &&
+        (!(params->flags & BOOT_RECORD_FLAG_NAME_IDS) ||
+         (params->flags & (BOOT_RECORD_FLAG_CONCURRENT | BOOT_RECORD_FLAG_RING |
+                           BOOT_RECORD_FLAG_COMPACT))))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if ((params->flags & BOOT_RECORD_FLAG_PER_CPU) &&
+        (params->num_cpus == 0 || params->num_cpus > BOOT_RECORD_MAX_CPUS ||
+         !boot_record_get_cpu_id))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+#if !defined(BOOT_RECORD_TIMESTAMP) && !defined(BOOT_RECORD_INLINE_COUNTER)
+    if (!boot_record_get_timestamp && !boot_record_get_counter)
     {
         return BOOT_RECORD_ERR_INVALID_PARAMS;
     }
+#endif
+
+    /* Site IDs are range checked against the site table of the image */
+    if (params->flags & BOOT_RECORD_FLAG_SITE_IDS)
+    {
+        if (!(params->flags & BOOT_RECORD_FLAG_NAME_IDS) ||
+            boot_record_site_count() > BOOT_RECORD_MAX_NAMES)
+        {
+            return BOOT_RECORD_ERR_INVALID_PARAMS;
+        }
+
+        name_capacity = boot_record_site_count();
+    }
+    /* The name table sits at the end of the region, after the records */
+    else if (params->flags & BOOT_RECORD_FLAG_NAME_IDS)
+    {
+        uint64_t table_size = (uint64_t)params->name_capacity *
+                              BOOT_RECORD_NAME_LEN;
+
+        if (params->name_capacity == 0 ||
+            params->name_capacity > BOOT_RECORD_MAX_NAMES)
+        {
+            return BOOT_RECORD_ERR_INVALID_PARAMS;
+        }
+
+        if (table_size + sizeof(boot_stage_record_t) +
+            boot_record_record_size(params->flags) > size)
+        {
+            return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+        }
+
+        name_offset = (size - (uint32_t)table_size) & ~7U;
+        name_capacity = params->name_capacity;
+        record_space = name_offset;
+    }
 
-    /* Clear the memory area */
-    memset(memory_addr, 0, size);
-    memset(&gboot_records_config, 0, sizeof(gboot_records_config));
+    /* Clear the memory area, or only what a lazy init relies on. Records are
+     * bounded by record_count, but name table slots are matched by content */
+    if (params->flags & BOOT_RECORD_FLAG_LAZY_INIT)
+    {
+        memset(memory_addr, 0, sizeof(boot_stage_record_t));
+        if (name_offset)
+        {
+            memset((uint8_t *)memory_addr + name_offset, 0,
+                   params->name_capacity * BOOT_RECORD_NAME_LEN);
+        }
+    }
+    else
+    {
+        memset(memory_addr, 0, size);
+    }
+    memset(ctx, 0, sizeof(*ctx));
 
     /* Initialize the main boot records structure */
-    gboot_records_config.memory_base = memory_addr;
-    gboot_records_config.memory_size = size;
-    gboot_records_config.records = (boot_stage_record_t *)memory_addr;
+    ctx->memory_base = memory_addr;
+    ctx->memory_size = size;
+    ctx->records = (boot_stage_record_t *)memory_addr;
+
+    boot_stage_record_t *stage = ctx->records;
+    stage->record_id = stage_id;
+    stage->record_count = 0;
+    stage->flags = params->flags;
+    stage->tick_rate_hz = params->tick_rate_hz;
+    boot_record_set_format(stage);
+
+    stage->name_offset = name_offset;
+    stage->name_capacity = name_capacity;
+
+    if (params->flags & BOOT_RECORD_FLAG_PER_CPU)
+    {
+        status = boot_record_split_cpus(stage, record_space, params->num_cpus);
+        if (status != BOOT_RECORD_SUCCESS)
+        {
+            ctx->records = NULL;
+            return status;
+        }
+    }
+    else
+    {
+        /* Calculate number of profile records that can fit */
+        stage->possible_records = (record_space - sizeof(boot_stage_record_t)) /
+                                  boot_record_record_size(params->flags);
+    }
 
-    /* Calculate number of profile records that can fit */
-    gboot_records_config.possible_records = (size - \
-                                            sizeof(boot_stage_record_t)) /
-                                            sizeof(boot_record_profile_t);
+    ctx->possible_records = stage->possible_records;
 
-    if (gboot_records_config.possible_records == 0)
+    if (ctx->possible_records == 0)
     {
         return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
     }
 
+    ctx->scrub_stage = BOOT_RECORD_SCRUB_DONE;
+
+    if (params->flags & BOOT_RECORD_FLAG_LAZY_INIT)
+    {
+        uint32_t cpu;
+
+        if (params->flags & BOOT_RECORD_FLAG_CONCURRENT)
+        {
+            if (params->flags & BOOT_RECORD_FLAG_PER_CPU)
+            {
+                for (cpu = 0; cpu < stage->cpu_count; cpu++)
+                {
+                    boot_record_clear_markers(boot_record_cpu_stage(stage, cpu));
+                }
+            }
+            else
+            {
+                boot_record_clear_markers(stage);
+            }
+        }
+
+        ctx->scrub_stage = 0;
+        ctx->scrub_slot =
+            (params->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+            boot_record_cpu_stage(stage, 0)->possible_records :
+            stage->possible_records;
+    }
+
     /* Initialize the boot stage record */
-    boot_stage_record_t *stage = gboot_records_config.records;
-    stage->record_id = stage_id;
-    stage->record_count = 0;
-    stage->start_time = boot_record_get_timestamp();
+    stage->start_time = boot_record_now();
+
+    /* Compact records store their time relative to their own sub-stage */
+    if (params->flags & BOOT_RECORD_FLAG_PER_CPU)
+    {
+        uint32_t cpu;
+
+        for (cpu = 0; cpu < stage->cpu_count; cpu++)
+        {
+            boot_record_cpu_stage(stage, cpu)->start_time = stage->start_time;
+        }
+    }
 
     return BOOT_RECORD_SUCCESS;
 }
 
 /**
- * Log a profile record with the current timestamp
+ * Create an empty boot record chain in a shared memory region
  */
-boot_record_status_t boot_record_log_profile(const char *name)
+boot_record_status_t boot_record_chain_create(void *memory_addr, uint32_t size)
 {
-    if (!name)
+    boot_record_chain_t *chain = (boot_record_chain_t *)memory_addr;
+
+    if (!memory_addr || size < sizeof(*chain))
     {
         return BOOT_RECORD_ERR_INVALID_PARAMS;
     }
 
-    /* Check if boot record is initialized */
-    if (!gboot_records_config.records || !gboot_records_config.memory_base)
+    memset(chain, 0, sizeof(*chain));
+    chain->size = size;
+    chain->tail_offset = sizeof(*chain);
+    chain->magic = BOOT_RECORD_CHAIN_MAGIC;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Initialize the boot records system in a new stage appended to a chain
+ */
+boot_record_status_t boot_record_chain_init(uint32_t stage_id,
+                                           void *memory_addr,
+                                           uint32_t stage_size,
+                                           const boot_record_params_t *params)
+{
+    return boot_record_ctx_chain_init(&gboot_records_config, stage_id,
+                                      memory_addr, stage_size, params);
+}
+
+/**
+ * Initialize a boot record context in a new stage appended to a chain
+ */
+boot_record_status_t boot_record_ctx_chain_init(boot_records_t *ctx,
+                                               uint32_t stage_id,
+                                               void *memory_addr,
+                                               uint32_t stage_size,
+                                               const boot_record_params_t *params)
+{
+    boot_record_chain_t *chain = (boot_record_chain_t *)memory_addr;
+    boot_record_chain_entry_t *entry;
+    boot_record_status_t status;
+    uint32_t offset;
+
+    if (!memory_addr || chain->magic != BOOT_RECORD_CHAIN_MAGIC ||
+        chain->tail_offset < sizeof(*chain) || chain->tail_offset > chain->size)
     {
         return BOOT_RECORD_ERR_INVALID_PARAMS;
     }
 
-    boot_stage_record_t *stage = gboot_records_config.records;
+    if (chain->stage_count >= BOOT_RECORD_MAX_STAGES)
+    {
+        return BOOT_RECORD_ERR_OVERFLOW;
+    }
+
+    /* Append at the stored tail, no need to walk earlier stages */
+    offset = (chain->tail_offset + 7U) & ~7U;
+    if (offset >= chain->size)
+    {
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+
+    if (stage_size == 0)
+    {
+        stage_size = chain->size - offset;
+    }
+    else if (stage_size > chain->size - offset)
+    {
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+
+    status = boot_record_ctx_init_ex(ctx, stage_id,
+                                     (uint8_t *)memory_addr + offset,
+                                     stage_size, params);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    entry = &chain->stages[chain->stage_count];
+    entry->offset = offset;
+    entry->size = stage_size;
+    chain->tail_offset = offset + stage_size;
+    chain->stage_count++;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Get the stage the calling CPU logs into
+ *
+ * \param ctx Boot record context
+ * \return Boot stage or per-CPU sub-stage, NULL if not initialized
+ */
+static boot_stage_record_t *boot_record_current_stage(const boot_records_t *ctx)
+{
+    boot_stage_record_t *stage;
+
+    /* Check if boot record is initialized */
+    if (!ctx || !ctx->records || !ctx->memory_base)
+    {
+        return NULL;
+    }
+
+    stage = ctx->records;
+
+    /* Each CPU logs into its own sub-stage */
+    if (stage->flags & BOOT_RECORD_FLAG_PER_CPU)
+    {
+        uint32_t cpu_id = boot_record_get_cpu_id();
+
+        if (cpu_id >= stage->cpu_count)
+        {
+            return NULL;
+        }
+
+        stage = boot_record_cpu_stage(stage, cpu_id);
+    }
+
+    return stage;
+}
+
+/**
+ * Map an index in logging order to a slot of the record array
+ */
+static uint32_t boot_record_slot(const boot_stage_record_t *stage,
+                                 uint32_t index)
+{
+    if (!(stage->flags & BOOT_RECORD_FLAG_RING))
+    {
+        return index;
+    }
+
+    index += stage->head;
+
+    return (index >= stage->possible_records) ?
+           index - stage->possible_records : index;
+}
+
+/**
+ * Reserve the next profile slot of a boot stage
+ *
+ * With BOOT_RECORD_FLAG_CONCURRENT the slot index is claimed with a single
+ * fetch-and-add on record_count, so no lock is taken, and the writer
+ * publishes the record through its commit marker. Otherwise the writer
+ * calls boot_record_commit once the record is complete. A full ring hands
+ * out the slot of the oldest record.
+ */
+static boot_record_status_t boot_record_reserve(boot_stage_record_t *stage,
+                                                uint32_t *index)
+{
+    if (!(stage->flags & BOOT_RECORD_FLAG_CONCURRENT))
+    {
+        /* Check if we've reached the maximum number of profiles */
+        if (stage->record_count < stage->possible_records)
+        {
+            /* The head only moves once the ring is full */
+            *index = stage->record_count;
+        }
+        else if (stage->flags & BOOT_RECORD_FLAG_RING)
+        {
+            *index = stage->head;
+        }
+        else
+        {
+            return BOOT_RECORD_ERR_OVERFLOW;
+        }
+
+        return BOOT_RECORD_SUCCESS;
+    }
 
-    /* Check if we've reached the maximum number of profiles */
-    if (stage->record_count >= gboot_records_config.possible_records)
+    /* Bail out early once full so record_count overshoots by at most one
+     * reservation per core */
+    if (__atomic_load_n(&stage->record_count, __ATOMIC_RELAXED) >=
+        stage->possible_records)
     {
         return BOOT_RECORD_ERR_OVERFLOW;
     }
 
-    /* Get pointer to the next available profile record */
-    boot_record_profile_t *profile = &stage->profiles[stage->record_count];
+    *index = __atomic_fetch_add(&stage->record_count, 1U, __ATOMIC_RELAXED);
+    if (*index >= stage->possible_records)
+    {
+        return BOOT_RECORD_ERR_OVERFLOW;
+    }
 
-    /* Copy profile name with length limit */
-    strncpy(profile->name, name, sizeof(profile->name) - 1);
-    profile->name[sizeof(profile->name) - 1] = '\0'; /* Ensure null termination */
+    return BOOT_RECORD_SUCCESS;
+}
 
-    /* Store the current time */
-    profile->time = boot_record_get_timestamp();
+/**
+ * Account for a record written to a slot from boot_record_reserve
+ *
+ * Not used in concurrent mode, where the commit marker publishes a record.
+ */
+static void boot_record_commit(boot_stage_record_t *stage)
+{
+    if (stage->record_count < stage->possible_records)
+    {
+        /* Increment profile record counter */
+        stage->record_count++;
+        return;
+    }
 
-    /* Increment profile record counter */
-    stage->record_count++;
+    /* The oldest record was overwritten, the next one becomes the head */
+    stage->head = (stage->head + 1U < stage->possible_records) ?
+                  stage->head + 1U : 0U;
+    stage->lost_count++;
+}
+
+/**
+ * Append a record holding a copy of the name
+ *
+ * In concurrent mode the last byte of the name is written last with release
+ * ordering and acts as the commit marker, which limits names to 22
+ * characters.
+ */
+static boot_record_status_t boot_record_write_name(boot_stage_record_t *stage,
+                                                   const char *name)
+{
+    boot_record_profile_t *profile;
+    boot_record_status_t status;
+    uint32_t index;
+
+    status = boot_record_reserve(stage, &index);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    /* Get pointer to the next available profile record */
+    profile = &stage->profiles[index];
+
+    if (stage->flags & BOOT_RECORD_FLAG_CONCURRENT)
+    {
+        strncpy(profile->name, name, sizeof(profile->name) - 2);
+        profile->name[sizeof(profile->name) - 2] = '\0';
+        profile->time = boot_record_now();
+
+        /* Publish the record */
+        __atomic_store_n(&profile->name[sizeof(profile->name) - 1],
+                         (char)BOOT_RECORD_COMMIT_MARK, __ATOMIC_RELEASE);
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    /* Copy profile name with length limit */
+    strncpy(profile->name, name, sizeof(profile->name) - 1);
+    profile->name[sizeof(profile->name) - 1] = '\0'; /* Ensure null termination */
+
+    /* Store the current time */
+    profile->time = boot_record_now();
+
+    boot_record_commit(stage);
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Append a record referring to an interned name
+ *
+ * Records are numbered in logging order, counting overwritten ones, so a
+ * link stays valid when a ring wraps.
+ *
+ * \param info Kind and depth fields of the record
+ * \param link Number + 1 of the record to link to, 0 for none
+ * \param number Pointer to receive the number of the record, may be NULL
+ */
+static boot_record_status_t boot_record_write_id(boot_stage_record_t *stage,
+                                                 uint32_t name_id,
+                                                 uint32_t info,
+                                                 uint32_t link,
+                                                 uint32_t *number)
+{
+    boot_record_compact_profile_t *compact;
+    boot_record_id_profile_t *profile;
+    boot_record_status_t status;
+    uint64_t data;
+    uint32_t index;
+    uint32_t seq;
+
+    status = boot_record_reserve(stage, &index);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    /* Compact records are points only, they have no info field */
+    if (stage->flags & BOOT_RECORD_FLAG_COMPACT)
+    {
+        compact = (boot_record_compact_profile_t *)stage->profiles + index;
+        data = (boot_record_now() - stage->start_time) <<
+               BOOT_RECORD_COMPACT_TIME_SHIFT;
+        data |= name_id + 1U;
+
+        if (stage->flags & BOOT_RECORD_FLAG_CONCURRENT)
+        {
+            /* Publish the record */
+            __atomic_store_n(&compact->data, data, __ATOMIC_RELEASE);
+            return BOOT_RECORD_SUCCESS;
+        }
+
+        compact->data = data;
+        boot_record_commit(stage);
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    seq = (stage->flags & BOOT_RECORD_FLAG_CONCURRENT) ?
+          index : stage->record_count + stage->lost_count;
+
+    /* Links too far back to encode are dropped */
+    if (link && (seq - (link - 1U)) <= BOOT_RECORD_INFO_LINK_MASK)
+    {
+        info |= seq - (link - 1U);
+    }
+
+    if (number)
+    {
+        *number = seq;
+    }
+
+    profile = (boot_record_id_profile_t *)stage->profiles + index;
+    profile->name_id = name_id;
+    profile->time = boot_record_now();
+
+    if (stage->flags & BOOT_RECORD_FLAG_CONCURRENT)
+    {
+        /* Publish the record */
+        __atomic_store_n(&profile->info, info | BOOT_RECORD_INFO_COMMIT,
+                         __ATOMIC_RELEASE);
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    profile->info = info;
+    boot_record_commit(stage);
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Encode a LEB128 varint
+ *
+ * \return Number of bytes written, at most 10
+ */
+static uint32_t boot_record_put_varint(uint8_t *out, uint64_t value)
+{
+    uint32_t length = 0;
+
+    while (value >= 0x80U)
+    {
+        out[length++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+
+    return length;
+}
+
+/**
+ * Decode a LEB128 varint that must end before end
+ *
+ * \return 1 on success, 0 if it is truncated or too long
+ */
+static int boot_record_get_varint(const uint8_t **pos, const uint8_t *end,
+                                  uint64_t *value)
+{
+    uint64_t result = 0;
+    uint32_t shift = 0;
+    uint8_t byte;
+
+    do
+    {
+        if (*pos >= end || shift > 63U)
+        {
+            return 0;
+        }
+        byte = *(*pos)++;
+        result |= (uint64_t)(byte & 0x7FU) << shift;
+        shift += 7U;
+    } while (byte & 0x80U);
+
+    *value = result;
+
+    return 1;
+}
+
+/**
+ * Append a record to the stream of a stage
+ *
+ * A record that does not fit the rest of the current block starts a new
+ * block, and so does a timestamp older than the previous one, which an
+ * unsigned delta can't express. The block count, stream size and record
+ * count are raised with release stores after the record bytes are written,
+ * so a reader that loads record_count first never decodes a partial record.
+ */
+static boot_record_status_t boot_record_write_stream(boot_records_t *ctx,
+                                                     boot_stage_record_t *stage,
+                                                     uint32_t name_id)
+{
+    boot_record_stream_block_t *block;
+    uint8_t record[BOOT_RECORD_STREAM_RECORD_MAX];
+    uint8_t *data = (uint8_t *)stage->profiles;
+    uint32_t offset = stage->stream_size;
+    uint32_t length;
+    uint32_t index;
+    uint64_t *last;
+    uint64_t now;
+    int fits = 0;
+
+    last = &ctx->stream_time[(ctx->records->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+                             boot_record_get_cpu_id() : 0U];
+    now = boot_record_now();
+
+    length = boot_record_put_varint(record, name_id);
+    if ((offset % BOOT_RECORD_STREAM_BLOCK_SIZE) != 0U && now >= *last)
+    {
+        length += boot_record_put_varint(record + length, now - *last);
+        fits = (length <= BOOT_RECORD_STREAM_BLOCK_SIZE -
+                          offset % BOOT_RECORD_STREAM_BLOCK_SIZE);
+    }
+
+    if (!fits)
+    {
+        index = (offset + BOOT_RECORD_STREAM_BLOCK_SIZE - 1U) /
+                BOOT_RECORD_STREAM_BLOCK_SIZE;
+        if (index >= stage->possible_records)
+        {
+            return BOOT_RECORD_ERR_OVERFLOW;
+        }
+
+        /* Sync point, the first record of the block has no delta */
+        block = (boot_record_stream_block_t *)(data + index * BOOT_RECORD_STREAM_BLOCK_SIZE);
+        block->time = now;
+        block->first = stage->record_count;
+        block->count = 0;
+
+        offset = index * BOOT_RECORD_STREAM_BLOCK_SIZE + (uint32_t)sizeof(*block);
+        length = boot_record_put_varint(record, name_id);
+        record[length++] = 0;
+    }
+
+    memcpy(data + offset, record, length);
+
+    block = (boot_record_stream_block_t *)(data + offset -
+                                           offset % BOOT_RECORD_STREAM_BLOCK_SIZE);
+    /* Publish the record, record_count last as readers load it first */
+    __atomic_store_n(&block->count, block->count + 1U, __ATOMIC_RELEASE);
+    __atomic_store_n(&stage->stream_size, offset + length, __ATOMIC_RELEASE);
+    __atomic_store_n(&stage->record_count, stage->record_count + 1U, __ATOMIC_RELEASE);
+    *last = now;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Check whether a name table slot holds the given name
+ */
+static int boot_record_name_matches(const char *slot, const char *name)
+{
+    return __atomic_load_n(&slot[0], __ATOMIC_ACQUIRE) == name[0] &&
+           strncmp(slot + 1, name + 1, BOOT_RECORD_NAME_LEN - 2U) == 0;
+}
+
+/**
+ * Find or add a name in the name table of the top-level stage
+ *
+ * Callers usually pass string literals, so the name pointer is first looked
+ * up in a small cache and only a cache miss scans the table. A slot is
+ * published by writing its first byte last, which is why empty names are
+ * rejected. When several cores may intern at once the slot is claimed
+ * atomically; two cores adding the same new name can end up with two IDs
+ * for it, which readers resolve to the same string.
+ */
+static boot_record_status_t boot_record_intern(boot_records_t *ctx,
+                                               boot_stage_record_t *stage,
+                                               const char *name,
+                                               uint32_t *name_id)
+{
+    char *table = (char *)stage + stage->name_offset;
+    uint32_t hash;
+    uint32_t count;
+    uint32_t id;
+    char *slot;
+
+    /* Site IDs have no name table to intern into */
+    if (!stage->name_offset || name[0] == '\0')
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    hash = (uint32_t)(((uintptr_t)name >> 2) ^ ((uintptr_t)name >> 9)) &
+           (BOOT_RECORD_NAME_CACHE_SIZE - 1U);
+
+    /* The cached ID is verified, so a stale or torn entry is harmless */
+    id = ctx->name_cache_id[hash];
+    if (ctx->name_cache[hash] == name &&
+        id < stage->name_capacity &&
+        boot_record_name_matches(table + id * BOOT_RECORD_NAME_LEN, name))
+    {
+        *name_id = id;
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    count = __atomic_load_n(&stage->name_count, __ATOMIC_ACQUIRE);
+    if (count > stage->name_capacity)
+    {
+        count = stage->name_capacity;
+    }
+
+    for (id = 0; id < count; id++)
+    {
+        if (boot_record_name_matches(table + id * BOOT_RECORD_NAME_LEN, name))
+        {
+            break;
+        }
+    }
+
+    if (id == count)
+    {
+        if (stage->flags & (BOOT_RECORD_FLAG_CONCURRENT | BOOT_RECORD_FLAG_PER_CPU))
+        {
+            id = __atomic_fetch_add(&stage->name_count, 1U, __ATOMIC_RELAXED);
+        }
+        else if (stage->name_count < stage->name_capacity)
+        {
+            id = stage->name_count++;
+        }
+        else
+        {
+            id = stage->name_capacity;
+        }
+
+        if (id >= stage->name_capacity)
+        {
+            return BOOT_RECORD_ERR_OVERFLOW;
+        }
+
+        slot = table + id * BOOT_RECORD_NAME_LEN;
+        strncpy(slot + 1, name + 1, BOOT_RECORD_NAME_LEN - 2U);
+        slot[BOOT_RECORD_NAME_LEN - 1U] = '\0';
+
+        /* Publish the name */
+        __atomic_store_n(&slot[0], name[0], __ATOMIC_RELEASE);
+    }
+
+    ctx->name_cache[hash] = name;
+    ctx->name_cache_id[hash] = id;
+    *name_id = id;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Log a profile record with the current timestamp
+ */
+boot_record_status_t boot_record_log_profile(const char *name)
+{
+    return boot_record_ctx_log(&gboot_records_config, name);
+}
+
+/**
+ * Log a profile record to a context with the current timestamp
+ */
+boot_record_status_t boot_record_ctx_log(boot_records_t *ctx, const char *name)
+{
+    boot_stage_record_t *stage;
+    boot_record_status_t status;
+    uint32_t name_id;
+
+    if (!name)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    stage = boot_record_current_stage(ctx);
+    if (!stage)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if (!(stage->flags & BOOT_RECORD_FLAG_NAME_IDS))
+    {
+        return boot_record_write_name(stage, name);
+    }
+
+    status = boot_record_intern(ctx, ctx->records, name, &name_id);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    if (stage->flags & BOOT_RECORD_FLAG_STREAM)
+    {
+        return boot_record_write_stream(ctx, stage, name_id);
+    }
+
+    return boot_record_write_id(stage, name_id, 0, 0, NULL);
+}
+
+/**
+ * Clear part of the unused record slots left stale by a lazy init
+ */
+boot_record_status_t boot_record_scrub(uint32_t max_bytes)
+{
+    return boot_record_ctx_scrub(&gboot_records_config, max_bytes);
+}
+
+/**
+ * Clear part of the unused record slots of a context left stale by a lazy init
+ */
+boot_record_status_t boot_record_ctx_scrub(boot_records_t *ctx, uint32_t max_bytes)
+{
+    boot_stage_record_t *stage;
+    boot_stage_record_t *sub;
+    uint32_t stage_count;
+    uint32_t stride;
+    uint32_t used;
+    uint32_t chunk;
+
+    if (!ctx || !ctx->records)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    stage = ctx->records;
+
+    stage_count = (stage->flags & BOOT_RECORD_FLAG_PER_CPU) ? stage->cpu_count : 1U;
+    stride = boot_record_record_size(stage->flags);
+
+    /* Slots are cleared whole, a smaller budget would never make progress */
+    if (ctx->scrub_stage < stage_count && max_bytes < stride)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    while (ctx->scrub_stage < stage_count)
+    {
+        sub = (stage->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+              boot_record_cpu_stage(stage, ctx->scrub_stage) :
+              stage;
+        used = (stage->flags & BOOT_RECORD_FLAG_STREAM) ?
+               (sub->stream_size + stride - 1U) / stride :
+               boot_record_get_count(sub);
+
+        if (ctx->scrub_slot > used)
+        {
+            chunk = ctx->scrub_slot - used;
+            if (chunk > max_bytes / stride)
+            {
+                chunk = max_bytes / stride;
+            }
+
+            ctx->scrub_slot -= chunk;
+            max_bytes -= chunk * stride;
+            memset((uint8_t *)sub->profiles +
+                   ctx->scrub_slot * stride, 0, chunk * stride);
+
+            if (ctx->scrub_slot > used)
+            {
+                return BOOT_RECORD_ERR_PENDING;
+            }
+        }
+
+        if (++ctx->scrub_stage < stage_count)
+        {
+            sub = boot_record_cpu_stage(stage, ctx->scrub_stage);
+            ctx->scrub_slot = sub->possible_records;
+        }
+    }
+
+    ctx->scrub_stage = BOOT_RECORD_SCRUB_DONE;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Intern a profile name and get its name ID
+ */
+boot_record_status_t boot_record_register_name(const char *name,
+                                              uint32_t *name_id)
+{
+    return boot_record_ctx_register_name(&gboot_records_config, name, name_id);
+}
+
+/**
+ * Intern a profile name in a context and get its name ID
+ */
+boot_record_status_t boot_record_ctx_register_name(boot_records_t *ctx,
+                                                  const char *name,
+                                                  uint32_t *name_id)
+{
+    boot_stage_record_t *stage = ctx ? ctx->records : NULL;
+
+    if (!name || !name_id || !stage ||
+        !(stage->flags & BOOT_RECORD_FLAG_NAME_IDS))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    return boot_record_intern(ctx, stage, name, name_id);
+}
+
+/**
+ * Log a profile record for a registered name ID with the current timestamp
+ */
+boot_record_status_t boot_record_log_id(uint32_t name_id)
+{
+    return boot_record_ctx_log_id(&gboot_records_config, name_id);
+}
+
+/**
+ * Log a profile record for a registered name ID to a context
+ */
+boot_record_status_t boot_record_ctx_log_id(boot_records_t *ctx, uint32_t name_id)
+{
+    boot_stage_record_t *stage = boot_record_current_stage(ctx);
+
+    if (!stage || !(stage->flags & BOOT_RECORD_FLAG_NAME_IDS) ||
+        name_id >= stage->name_capacity)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if (stage->flags & BOOT_RECORD_FLAG_STREAM)
+    {
+        return boot_record_write_stream(ctx, stage, name_id);
+    }
+
+    return boot_record_write_id(stage, name_id, 0, 0, NULL);
+}
+
+/**
+ * Check whether the records of a stage store a kind, depth and link
+ */
+static int boot_record_has_info(const boot_stage_record_t *stage)
+{
+    return (stage->flags & (BOOT_RECORD_FLAG_NAME_IDS | BOOT_RECORD_FLAG_COMPACT |
+                            BOOT_RECORD_FLAG_STREAM)) == BOOT_RECORD_FLAG_NAME_IDS;
+}
+
+/**
+ * Get the CPU whose span nesting applies to the caller
+ *
+ * Without a CPU ID hook every core would share the nesting state of CPU 0,
+ * which concurrent stages can't allow.
+ *
+ * \param stage Stage the caller logs into, NULL if not initialized
+ * \return CPU index, BOOT_RECORD_MAX_CPUS if out of range or unknown
+ */
+static uint32_t boot_record_span_cpu(const boot_stage_record_t *stage)
+{
+    uint32_t cpu_id;
+
+    if (!boot_record_get_cpu_id)
+    {
+        return (stage && (stage->flags & BOOT_RECORD_FLAG_CONCURRENT)) ?
+               BOOT_RECORD_MAX_CPUS : 0U;
+    }
+
+    cpu_id = boot_record_get_cpu_id();
+
+    return (cpu_id < BOOT_RECORD_MAX_CPUS) ? cpu_id : BOOT_RECORD_MAX_CPUS;
+}
+
+/**
+ * Open a span for a registered name ID with the current timestamp
+ */
+boot_record_status_t boot_record_begin_id(uint32_t name_id)
+{
+    return boot_record_ctx_begin_id(&gboot_records_config, name_id);
+}
+
+/**
+ * Open a span in a context for a registered name ID
+ */
+boot_record_status_t boot_record_ctx_begin_id(boot_records_t *ctx, uint32_t name_id)
+{
+    boot_stage_record_t *stage = boot_record_current_stage(ctx);
+    boot_record_status_t status;
+    uint32_t cpu_id = boot_record_span_cpu(stage);
+    uint32_t depth;
+    uint32_t seq;
+
+    if (!stage || !boot_record_has_info(stage) ||
+        name_id >= stage->name_capacity || cpu_id >= BOOT_RECORD_MAX_CPUS)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    depth = ctx->span_depth[cpu_id];
+    if (depth >= BOOT_RECORD_MAX_SPAN_DEPTH)
+    {
+        return BOOT_RECORD_ERR_OVERFLOW;
+    }
+
+    status = boot_record_write_id(stage, name_id,
+                                  BOOT_RECORD_INFO(BOOT_RECORD_KIND_BEGIN, depth, 0),
+                                  ctx->span_open[cpu_id], &seq);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    ctx->span_open[cpu_id] = seq + 1U;
+    ctx->span_depth[cpu_id] = depth + 1U;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Open a span with the current timestamp
+ */
+boot_record_status_t boot_record_begin(const char *name)
+{
+    return boot_record_ctx_begin(&gboot_records_config, name);
+}
+
+/**
+ * Open a span in a context with the current timestamp
+ */
+boot_record_status_t boot_record_ctx_begin(boot_records_t *ctx, const char *name)
+{
+    boot_record_status_t status;
+    uint32_t name_id;
+
+    status = boot_record_ctx_register_name(ctx, name, &name_id);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    return boot_record_ctx_begin_id(ctx, name_id);
+}
+
+/**
+ * Get the name ID of a site table entry
+ */
+uint32_t boot_record_site_id(const boot_record_site_t *site)
+{
+    if (!site || site < __start_bootrecord_sites || site >= __stop_bootrecord_sites)
+    {
+        return BOOT_RECORD_NAME_ID_NONE;
+    }
+
+    return (uint32_t)(site - __start_bootrecord_sites);
+}
+
+/**
+ * Log a profile record for a site with the current timestamp
+ */
+boot_record_status_t boot_record_log_site(const boot_record_site_t *site)
+{
+    return boot_record_ctx_log_site(&gboot_records_config, site);
+}
+
+/**
+ * Log a profile record for a site to a context
+ */
+boot_record_status_t boot_record_ctx_log_site(boot_records_t *ctx,
+                                             const boot_record_site_t *site)
+{
+    /* Sub-stages inherit the flags, and log_id checks the ID range */
+    if (!ctx || !ctx->records || !(ctx->records->flags & BOOT_RECORD_FLAG_SITE_IDS))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    return boot_record_ctx_log_id(ctx, boot_record_site_id(site));
+}
+
+/**
+ * Open a span for a site with the current timestamp
+ */
+boot_record_status_t boot_record_begin_site(const boot_record_site_t *site)
+{
+    return boot_record_ctx_begin_site(&gboot_records_config, site);
+}
+
+/**
+ * Open a span in a context for a site
+ */
+boot_record_status_t boot_record_ctx_begin_site(boot_records_t *ctx,
+                                               const boot_record_site_t *site)
+{
+    if (!ctx || !ctx->records || !(ctx->records->flags & BOOT_RECORD_FLAG_SITE_IDS))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    return boot_record_ctx_begin_id(ctx, boot_record_site_id(site));
+}
+
+/**
+ * Close the innermost open span of the calling CPU
+ */
+boot_record_status_t boot_record_end(void)
+{
+    return boot_record_ctx_end(&gboot_records_config);
+}
+
+/**
+ * Close the innermost open span of the calling CPU in a context
+ */
+boot_record_status_t boot_record_ctx_end(boot_records_t *ctx)
+{
+    boot_stage_record_t *stage = boot_record_current_stage(ctx);
+    const boot_record_id_profile_t *begin;
+    uint32_t cpu_id = boot_record_span_cpu(stage);
+    uint32_t name_id = BOOT_RECORD_NAME_ID_NONE;
+    uint32_t parent = 0;
+    uint32_t open;
+    uint32_t begin_seq;
+    uint32_t depth;
+    uint32_t link;
+
+    if (!stage || !boot_record_has_info(stage) ||
+        cpu_id >= BOOT_RECORD_MAX_CPUS ||
+        !ctx->span_depth[cpu_id])
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    open = ctx->span_open[cpu_id];
+    begin_seq = open - 1U;
+    depth = ctx->span_depth[cpu_id] - 1U;
+
+    /* The begin record holds the name and the link to the enclosing span,
+     * unless its own link was dropped or a ring has overwritten it since */
+    if (open && begin_seq >= stage->lost_count)
+    {
+        begin = (const boot_record_id_profile_t *)stage->profiles +
+                boot_record_slot(stage, begin_seq - stage->lost_count);
+        name_id = begin->name_id;
+        link = begin->info & BOOT_RECORD_INFO_LINK_MASK;
+        if (link)
+        {
+            parent = begin_seq - link + 1U;
+        }
+    }
+
+    /* Unwind even if the end record does not fit, so nesting stays right */
+    ctx->span_open[cpu_id] = parent;
+    ctx->span_depth[cpu_id] = depth;
+
+    return boot_record_write_id(stage, name_id,
+                                BOOT_RECORD_INFO(BOOT_RECORD_KIND_END, depth, 0),
+                                open, NULL);
+}
+
+/**
+ * Log that a point was reached after waiting for another record
+ */
+boot_record_status_t boot_record_wait(const char *name, const char *waited_on)
+{
+    return boot_record_ctx_wait(&gboot_records_config, name, waited_on);
+}
+
+/**
+ * Log a wait record to a context
+ */
+boot_record_status_t boot_record_ctx_wait(boot_records_t *ctx, const char *name,
+                                          const char *waited_on)
+{
+    boot_record_status_t status;
+    uint32_t name_id;
+    uint32_t wait_id;
+
+    status = boot_record_ctx_register_name(ctx, name, &name_id);
+    if (status == BOOT_RECORD_SUCCESS)
+    {
+        status = boot_record_ctx_register_name(ctx, waited_on, &wait_id);
+    }
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    return boot_record_ctx_wait_id(ctx, name_id, wait_id);
+}
+
+/**
+ * Log a wait record for registered name IDs with the current timestamp
+ */
+boot_record_status_t boot_record_wait_id(uint32_t name_id, uint32_t wait_id)
+{
+    return boot_record_ctx_wait_id(&gboot_records_config, name_id, wait_id);
+}
+
+/**
+ * Log a wait record for registered name IDs to a context
+ */
+boot_record_status_t boot_record_ctx_wait_id(boot_records_t *ctx, uint32_t name_id,
+                                             uint32_t wait_id)
+{
+    boot_stage_record_t *stage = boot_record_current_stage(ctx);
+
+    if (!stage || !boot_record_has_info(stage) ||
+        name_id >= stage->name_capacity || wait_id >= stage->name_capacity)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    /* name_capacity never exceeds BOOT_RECORD_MAX_NAMES, so the name ID
+     * fits the link field */
+    return boot_record_write_id(stage, name_id,
+                                BOOT_RECORD_INFO(BOOT_RECORD_KIND_WAIT, 0, wait_id),
+                                0, NULL);
+}
+
+/**
+ * Check that a stage header was written with the layout of this build
+ */
+static int boot_record_format_valid(const boot_stage_record_t *stage)
+{
+    return stage->magic == BOOT_RECORD_MAGIC &&
+           stage->version == BOOT_RECORD_FORMAT_VERSION &&
+           stage->byte_order == BOOT_RECORD_BYTE_ORDER &&
+           stage->header_size == sizeof(*stage) &&
+           stage->record_stride == boot_record_get_stride(stage) &&
+           (!(stage->flags & (BOOT_RECORD_FLAG_COMPACT | BOOT_RECORD_FLAG_STREAM |
+                              BOOT_RECORD_FLAG_SITE_IDS)) ||
+            (stage->flags & BOOT_RECORD_FLAG_NAME_IDS)) &&
+           stage->name_len == BOOT_RECORD_NAME_LEN &&
+           stage->time_unit <= BOOT_RECORD_TIME_TICKS;
+}
+
+/**
+ * Check that the name table of a stage lies within its memory
+ *
+ * \param stage Stage or per-CPU sub-stage to check
+ * \param name_room Bytes from the header to the end of the memory
+ */
+static int boot_record_names_valid(const boot_stage_record_t *stage,
+                                   uint32_t name_room)
+{
+    return !stage->name_offset ||
+           (stage->name_offset <= name_room &&
+            stage->name_capacity <= (name_room - stage->name_offset) /
+                                    BOOT_RECORD_NAME_LEN);
+}
+
+/**
+ * Check that the records and name table of a stage lie within its memory
+ *
+ * \param stage Stage or per-CPU sub-stage to check
+ * \param record_room Bytes from the header available to its records
+ * \param name_room Bytes from the header to the end of the memory
+ */
+static int boot_record_bounds_valid(const boot_stage_record_t *stage,
+                                    uint32_t record_room, uint32_t name_room)
+{
+    if (record_room < sizeof(*stage) ||
+        stage->possible_records > (record_room - sizeof(*stage)) /
+                                  stage->record_stride ||
+        (stage->head && stage->head >= stage->possible_records) ||
+        stage->stream_size > stage->possible_records * stage->record_stride)
+    {
+        return 0;
+    }
+
+    return boot_record_names_valid(stage, name_room);
+}
+
+/**
+ * Check that memory holds a boot stage this build can read in place
+ */
+boot_record_status_t boot_record_validate(const void *memory_addr,
+                                         uint32_t size,
+                                         const boot_stage_record_t **stage)
+{
+    const boot_stage_record_t *top = (const boot_stage_record_t *)memory_addr;
+    const boot_stage_record_t *sub;
+    uint32_t offset;
+    uint32_t cpu;
+
+    if (!memory_addr || !stage || ((uintptr_t)memory_addr & 7U))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if (size < sizeof(*top) || !boot_record_format_valid(top))
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    /* Only a per-CPU stage has sub-stages, tools may walk them by count */
+    if (!(top->flags & BOOT_RECORD_FLAG_PER_CPU))
+    {
+        if (top->cpu_count || top->cpu_offset || top->cpu_stride ||
+            !boot_record_bounds_valid(top, size, size))
+        {
+            return BOOT_RECORD_ERR_FORMAT;
+        }
+
+        *stage = top;
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    /* Sub-stages are bounded by BOOT_RECORD_MAX_CPUS, not by the records.
+     * Every sub-stage header must fit in its stride before it is read */
+    if (top->cpu_count == 0 || top->cpu_count > BOOT_RECORD_MAX_CPUS ||
+        top->cpu_offset < sizeof(*top) || top->cpu_offset > size ||
+        (top->cpu_offset & 7U) || (top->cpu_stride & 7U) ||
+        top->cpu_stride < sizeof(*top) ||
+        top->cpu_stride > (size - top->cpu_offset) / top->cpu_count ||
+        !boot_record_names_valid(top, size))
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    for (cpu = 0; cpu < top->cpu_count; cpu++)
+    {
+        offset = top->cpu_offset + cpu * top->cpu_stride;
+        sub = boot_record_get_cpu_stage(top, cpu);
+
+        if (!boot_record_format_valid(sub) ||
+            (sub->flags & BOOT_RECORD_FLAG_PER_CPU) || sub->cpu_count ||
+            sub->cpu_offset || sub->cpu_stride ||
+            !boot_record_bounds_valid(sub, top->cpu_stride, size - offset))
+        {
+            return BOOT_RECORD_ERR_FORMAT;
+        }
+    }
+
+    *stage = top;
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Get the number of profile records that can be read from a boot stage
+ */
+uint32_t boot_record_get_count(const boot_stage_record_t *stage)
+{
+    uint32_t count;
+
+    if (!stage)
+    {
+        return 0;
+    }
+
+    /* A concurrent stage may have reserved past the end of the region. A
+     * stream holds more records than blocks */
+    count = __atomic_load_n(&stage->record_count, __ATOMIC_ACQUIRE);
+    if (count > stage->possible_records && !(stage->flags & BOOT_RECORD_FLAG_STREAM))
+    {
+        count = stage->possible_records;
+    }
+
+    return count;
+}
+
+/**
+ * Get the size in bytes of one profile slot of a boot stage
+ */
+uint32_t boot_record_get_stride(const boot_stage_record_t *stage)
+{
+    return stage ? boot_record_record_size(stage->flags) : 0U;
+}
+
+/**
+ * Get a completely written profile record from a boot stage
+ */
+boot_record_status_t boot_record_get_profile(const boot_stage_record_t *stage,
+                                            uint32_t index,
+                                            const boot_record_profile_t **profile)
+{
+    const boot_record_profile_t *entry;
+
+    if (!stage || !profile || (stage->flags & BOOT_RECORD_FLAG_NAME_IDS) ||
+        index >= boot_record_get_count(stage))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    entry = &stage->profiles[boot_record_slot(stage, index)];
+
+    if ((stage->flags & BOOT_RECORD_FLAG_CONCURRENT) &&
+        ((uint8_t)__atomic_load_n(&entry->name[sizeof(entry->name) - 1],
+                                  __ATOMIC_ACQUIRE) != BOOT_RECORD_COMMIT_MARK))
+    {
+        return BOOT_RECORD_ERR_PENDING;
+    }
+
+    *profile = entry;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Decode a record of a stream, starting at the sync point of its block
+ */
+static boot_record_status_t boot_record_get_stream_event(const boot_stage_record_t *stage,
+                                                         uint32_t index,
+                                                         boot_record_event_t *event)
+{
+    const boot_record_stream_block_t *block;
+    const uint8_t *data = (const uint8_t *)stage->profiles;
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint64_t name_id;
+    uint64_t delta;
+    uint64_t time;
+    uint32_t low = 0;
+    uint32_t high;
+    uint32_t mid;
+    uint32_t i;
+
+    /* Last block starting at or before the record */
+    high = (stage->stream_size + BOOT_RECORD_STREAM_BLOCK_SIZE - 1U) /
+           BOOT_RECORD_STREAM_BLOCK_SIZE;
+    while (high - low > 1U)
+    {
+        mid = low + (high - low) / 2U;
+        block = (const boot_record_stream_block_t *)(data + mid * BOOT_RECORD_STREAM_BLOCK_SIZE);
+        if (block->first <= index)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    block = (const boot_record_stream_block_t *)(data + low * BOOT_RECORD_STREAM_BLOCK_SIZE);
+    if (index < block->first || index - block->first >= block->count)
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    pos = (const uint8_t *)(block + 1);
+    end = (const uint8_t *)block + BOOT_RECORD_STREAM_BLOCK_SIZE;
+    time = block->time;
+    for (i = block->first; ; i++)
+    {
+        if (!boot_record_get_varint(&pos, end, &name_id) ||
+            !boot_record_get_varint(&pos, end, &delta))
+        {
+            return BOOT_RECORD_ERR_FORMAT;
+        }
+        time += delta;
+
+        if (i == index)
+        {
+            break;
+        }
+    }
+
+    event->name_id = (uint32_t)name_id;
+    event->name = boot_record_get_name(stage, event->name_id);
+    event->time = time;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Decode a completely written profile record of any layout
+ */
+boot_record_status_t boot_record_get_event(const boot_stage_record_t *stage,
+                                          uint32_t index,
+                                          boot_record_event_t *event)
+{
+    const boot_record_compact_profile_t *compact;
+    const boot_record_id_profile_t *entry;
+    const boot_record_profile_t *profile;
+    boot_record_status_t status;
+    uint64_t offset;
+    uint64_t data;
+    uint32_t link;
+
+    if (!stage || !event || index >= boot_record_get_count(stage))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    event->cpu_id = 0;
+    event->kind = BOOT_RECORD_KIND_POINT;
+    event->depth = 0;
+    event->link = BOOT_RECORD_INDEX_NONE;
+    event->wait_id = BOOT_RECORD_NAME_ID_NONE;
+
+    if (!(stage->flags & BOOT_RECORD_FLAG_NAME_IDS))
+    {
+        status = boot_record_get_profile(stage, index, &profile);
+        if (status != BOOT_RECORD_SUCCESS)
+        {
+            return status;
+        }
+
+        event->name_id = BOOT_RECORD_NAME_ID_NONE;
+        event->name = profile->name;
+        event->time = profile->time;
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    if (stage->flags & BOOT_RECORD_FLAG_STREAM)
+    {
+        return boot_record_get_stream_event(stage, index, event);
+    }
+
+    if (stage->flags & BOOT_RECORD_FLAG_COMPACT)
+    {
+        compact = (const boot_record_compact_profile_t *)stage->profiles +
+                  boot_record_slot(stage, index);
+        data = (stage->flags & BOOT_RECORD_FLAG_CONCURRENT) ?
+               __atomic_load_n(&compact->data, __ATOMIC_ACQUIRE) : compact->data;
+        if (!(data & BOOT_RECORD_COMPACT_NAME_MASK))
+        {
+            return BOOT_RECORD_ERR_PENDING;
+        }
+
+        /* Sign extend the 48-bit offset */
+        offset = data >> BOOT_RECORD_COMPACT_TIME_SHIFT;
+        if (offset & (1ULL << (BOOT_RECORD_COMPACT_TIME_BITS - 1U)))
+        {
+            offset |= ~0ULL << BOOT_RECORD_COMPACT_TIME_BITS;
+        }
+
+        event->name_id = (uint32_t)(data & BOOT_RECORD_COMPACT_NAME_MASK) - 1U;
+        event->name = boot_record_get_name(stage, event->name_id);
+        event->time = stage->start_time + offset;
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    entry = (const boot_record_id_profile_t *)stage->profiles +
+            boot_record_slot(stage, index);
+
+    if ((stage->flags & BOOT_RECORD_FLAG_CONCURRENT) &&
+        !(__atomic_load_n(&entry->info, __ATOMIC_ACQUIRE) & BOOT_RECORD_INFO_COMMIT))
+    {
+        return BOOT_RECORD_ERR_PENDING;
+    }
+
+    event->name_id = entry->name_id;
+    event->name = boot_record_get_name(stage, entry->name_id);
+    event->kind = (entry->info >> BOOT_RECORD_INFO_KIND_SHIFT) &
+                  BOOT_RECORD_INFO_KIND_MASK;
+    event->depth = (entry->info >> BOOT_RECORD_INFO_DEPTH_SHIFT) &
+                   BOOT_RECORD_INFO_DEPTH_MASK;
+    link = entry->info & BOOT_RECORD_INFO_LINK_MASK;
+    if (event->kind == BOOT_RECORD_KIND_WAIT)
+    {
+        event->wait_id = link;
+    }
+    else if (link && link <= index)
+    {
+        event->link = index - link;
+    }
+    event->time = entry->time;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Get the profile records of a stage in logging order without copying
+ */
+boot_record_status_t boot_record_get_view(const boot_stage_record_t *stage,
+                                         boot_record_view_t *view)
+{
+    uint32_t stride;
+    uint32_t count;
+    uint32_t head;
+
+    if (!stage || !view || (stage->flags & BOOT_RECORD_FLAG_STREAM))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    stride = boot_record_get_stride(stage);
+    count = boot_record_get_count(stage);
+    head = (stage->flags & BOOT_RECORD_FLAG_RING) ? stage->head : 0U;
+
+    if (head >= count)
+    {
+        head = 0;
+    }
+
+    view->first = (const uint8_t *)stage->profiles + head * stride;
+    view->first_count = count - head;
+    view->second = stage->profiles;
+    view->second_count = head;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Look up a name in the name table of a boot stage
+ */
+const char *boot_record_get_name(const boot_stage_record_t *stage,
+                                 uint32_t name_id)
+{
+    const char *slot;
+
+    if (!stage || !stage->name_offset || name_id >= stage->name_capacity)
+    {
+        return NULL;
+    }
+
+    slot = (const char *)stage + stage->name_offset +
+           name_id * BOOT_RECORD_NAME_LEN;
+
+    /* An unpublished slot still has its first byte cleared */
+    if (__atomic_load_n(&slot[0], __ATOMIC_ACQUIRE) == '\0')
+    {
+        return NULL;
+    }
+
+    return slot;
+}
+
+/**
+ * Prepare conversion of a stage's timestamps to a time unit
+ */
+boot_record_status_t boot_record_tconv_init(boot_record_tconv_t *conv,
+                                           const boot_stage_record_t *stage,
+                                           uint32_t unit_hz)
+{
+    uint32_t from_hz;
+    uint32_t shift = 32U;
+    uint64_t mult;
+    uint64_t rem;
+
+    if (!conv || !stage || !unit_hz)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    from_hz = stage->tick_rate_hz ? stage->tick_rate_hz : BOOT_RECORD_UNIT_US;
+
+    mult = ((uint64_t)unit_hz << 32) / from_hz;
+    rem = ((uint64_t)unit_hz << 32) % from_hz;
+
+    if (mult > 0xFFFFFFFFU)
+    {
+        /* Scaling up: drop fraction bits until the multiplier fits */
+        do
+        {
+            shift--;
+            mult = (((uint64_t)unit_hz << shift) + from_hz / 2U) / from_hz;
+        } while (mult > 0xFFFFFFFFU && shift > 1U);
+
+        if (mult > 0xFFFFFFFFU)
+        {
+            return BOOT_RECORD_ERR_INVALID_PARAMS;
+        }
+    }
+    else
+    {
+        /* Scaling down: long-divide further fraction bits into the multiplier */
+        while (mult <= 0x7FFFFFFFU && shift < 63U)
+        {
+            rem <<= 1;
+            mult <<= 1;
+            if (rem >= from_hz)
+            {
+                rem -= from_hz;
+                mult |= 1U;
+            }
+            shift++;
+        }
+
+        if (rem * 2U >= from_hz && mult < 0xFFFFFFFFU)
+        {
+            mult++;
+        }
+    }
+
+    if (mult == 0U)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    conv->mult = (uint32_t)mult;
+    conv->shift = shift;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Convert a stage timestamp with a prepared converter
+ */
+uint64_t boot_record_tconv_apply(const boot_record_tconv_t *conv, uint64_t time)
+{
+    uint64_t high = (time >> 32) * conv->mult;
+    uint64_t low = (time & 0xFFFFFFFFU) * conv->mult;
+    uint64_t mid;
+    uint64_t top;
+
+    /* Form the 96-bit product as top:mid:low 32-bit words, then shift it */
+    mid = (high & 0xFFFFFFFFU) + (low >> 32);
+    top = (high >> 32) + (mid >> 32);
+    low = ((mid & 0xFFFFFFFFU) << 32) | (low & 0xFFFFFFFFU);
+
+    return (top << (64U - conv->shift)) | (low >> conv->shift);
+}
+
+/**
+ * Get a boot stage of a chain
+ */
+const boot_stage_record_t *boot_record_chain_get_stage(const boot_record_chain_t *chain,
+                                                       uint32_t index)
+{
+    if (!chain || chain->magic != BOOT_RECORD_CHAIN_MAGIC ||
+        index >= chain->stage_count || index >= BOOT_RECORD_MAX_STAGES)
+    {
+        return NULL;
+    }
+
+    return (const boot_stage_record_t *)((const uint8_t *)chain +
+                                         chain->stages[index].offset);
+}
+
+/**
+ * Get the sub-stage holding the records of one CPU
+ */
+const boot_stage_record_t *boot_record_get_cpu_stage(const boot_stage_record_t *stage,
+                                                     uint32_t cpu_id)
+{
+    if (!stage || !(stage->flags & BOOT_RECORD_FLAG_PER_CPU) ||
+        cpu_id >= stage->cpu_count)
+    {
+        return NULL;
+    }
+
+    return (const boot_stage_record_t *)((const uint8_t *)stage +
+                                         stage->cpu_offset +
+                                         cpu_id * stage->cpu_stride);
+}
+
+/**
+ * Position of one CPU in the k-way merge
+ */
+typedef struct
+{
+    const boot_stage_record_t *stage;
+    boot_record_event_t event;
+    uint32_t index;
+    uint32_t count;
+} boot_record_cursor_t;
+
+/**
+ * Move a merge cursor to its next committed record
+ *
+ * \return 1 if the cursor holds a record, 0 once it is exhausted
+ */
+static int boot_record_cursor_next(boot_record_cursor_t *cursor)
+{
+    uint32_t cpu_id = cursor->event.cpu_id;
+
+    while (cursor->index < cursor->count)
+    {
+        if (boot_record_get_event(cursor->stage, cursor->index++,
+                                  &cursor->event) == BOOT_RECORD_SUCCESS)
+        {
+            cursor->event.cpu_id = cpu_id;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int boot_record_cursor_before(const boot_record_cursor_t *a,
+                                     const boot_record_cursor_t *b)
+{
+    if (a->event.time != b->event.time)
+    {
+        return a->event.time < b->event.time;
+    }
+
+    return a->event.cpu_id < b->event.cpu_id;
+}
+
+/**
+ * Restore the min-heap property below position i
+ */
+static void boot_record_heap_down(boot_record_cursor_t **heap, uint32_t n,
+                                  uint32_t i)
+{
+    for (;;)
+    {
+        uint32_t min = i;
+        uint32_t left = 2U * i + 1U;
+        uint32_t right = left + 1U;
+        boot_record_cursor_t *tmp;
+
+        if (left < n && boot_record_cursor_before(heap[left], heap[min]))
+        {
+            min = left;
+        }
+        if (right < n && boot_record_cursor_before(heap[right], heap[min]))
+        {
+            min = right;
+        }
+        if (min == i)
+        {
+            return;
+        }
+
+        tmp = heap[i];
+        heap[i] = heap[min];
+        heap[min] = tmp;
+        i = min;
+    }
+}
+
+/**
+ * Merge the records of all CPUs into one stream ordered by time
+ */
+boot_record_status_t boot_record_merge(const boot_stage_record_t *stage,
+                                      boot_record_merge_fn fn,
+                                      void *arg)
+{
+    boot_record_cursor_t cursors[BOOT_RECORD_MAX_CPUS];
+    boot_record_cursor_t *heap[BOOT_RECORD_MAX_CPUS];
+    uint32_t cpu_count;
+    uint32_t n = 0;
+    uint32_t i;
+
+    if (!stage || !fn)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    cpu_count = (stage->flags & BOOT_RECORD_FLAG_PER_CPU) ? stage->cpu_count : 1U;
+    if (cpu_count == 0 || cpu_count > BOOT_RECORD_MAX_CPUS)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    for (i = 0; i < cpu_count; i++)
+    {
+        boot_record_cursor_t *cursor = &cursors[i];
+
+        cursor->stage = (stage->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+                        boot_record_get_cpu_stage(stage, i) : stage;
+        cursor->index = 0;
+        cursor->count = boot_record_get_count(cursor->stage);
+        cursor->event.cpu_id = i;
+
+        if (boot_record_cursor_next(cursor))
+        {
+            heap[n++] = cursor;
+        }
+    }
+
+    for (i = n / 2U; i-- > 0U;)
+    {
+        boot_record_heap_down(heap, n, i);
+    }
+
+    while (n > 0U)
+    {
+        fn(&heap[0]->event, arg);
+
+        if (!boot_record_cursor_next(heap[0]))
+        {
+            heap[0] = heap[--n];
+        }
+        boot_record_heap_down(heap, n, 0);
+    }
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Span whose end record has not been seen yet
+ */
+typedef struct
+{
+    uint32_t begin_index;
+    uint32_t parent_index;
+    uint64_t start_time;
+    uint64_t child_time;
+} boot_record_open_span_t;
+
+/**
+ * Compute span times of one stage or per-CPU sub-stage
+ */
+static boot_record_status_t boot_record_analyze_stage(const boot_stage_record_t *stage,
+                                                      uint32_t cpu_id,
+                                                      boot_record_span_fn fn,
+                                                      void *arg)
+{
+    boot_record_open_span_t open[BOOT_RECORD_MAX_SPAN_DEPTH];
+    boot_record_open_span_t *entry;
+    boot_record_event_t event;
+    boot_record_span_t span;
+    uint32_t count = boot_record_get_count(stage);
+    uint32_t n = 0;
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+
+    for (i = 0; i < count; i++)
+    {
+        if (boot_record_get_event(stage, i, &event) != BOOT_RECORD_SUCCESS)
+        {
+            continue;
+        }
+
+        if (event.kind == BOOT_RECORD_KIND_BEGIN)
+        {
+            if (n == BOOT_RECORD_MAX_SPAN_DEPTH)
+            {
+                return BOOT_RECORD_ERR_OVERFLOW;
+            }
+
+            entry = &open[n++];
+            entry->begin_index = i;
+            entry->parent_index = event.link;
+            entry->start_time = event.time;
+            entry->child_time = 0;
+            continue;
+        }
+
+        if (event.kind != BOOT_RECORD_KIND_END)
+        {
+            continue;
+        }
+
+        /* Spans of one CPU close innermost first, so this is usually the
+         * last open span; interleaved CPUs may close others */
+        for (j = n; j > 0U && open[j - 1U].begin_index != event.link; j--)
+        {
+        }
+        if (j == 0U)
+        {
+            continue;
+        }
+        entry = &open[j - 1U];
+
+        span.cpu_id = cpu_id;
+        span.name_id = event.name_id;
+        span.name = event.name;
+        span.depth = event.depth;
+        span.begin_index = entry->begin_index;
+        span.end_index = i;
+        span.parent_index = entry->parent_index;
+        span.start_time = entry->start_time;
+        span.inclusive_time = event.time - entry->start_time;
+        span.exclusive_time = (span.inclusive_time > entry->child_time) ?
+                              span.inclusive_time - entry->child_time : 0U;
+
+        for (k = 0; k < n; k++)
+        {
+            if (open[k].begin_index == entry->parent_index)
+            {
+                open[k].child_time += span.inclusive_time;
+                break;
+            }
+        }
+
+        fn(&span, arg);
+
+        /* Drop the closed span, keeping the others in order */
+        memmove(entry, entry + 1, (n - j) * sizeof(*entry));
+        n--;
+    }
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Compute inclusive and exclusive time of every span of a stage
+ */
+boot_record_status_t boot_record_analyze_spans(const boot_stage_record_t *stage,
+                                              boot_record_span_fn fn,
+                                              void *arg)
+{
+    boot_record_status_t status;
+    uint32_t cpu;
+
+    if (!stage || !fn)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if (!(stage->flags & BOOT_RECORD_FLAG_PER_CPU))
+    {
+        return boot_record_analyze_stage(stage, 0, fn, arg);
+    }
+
+    for (cpu = 0; cpu < stage->cpu_count; cpu++)
+    {
+        status = boot_record_analyze_stage(boot_record_get_cpu_stage(stage, cpu),
+                                           cpu, fn, arg);
+        if (status != BOOT_RECORD_SUCCESS)
+        {
+            return status;
+        }
+    }
 
     return BOOT_RECORD_SUCCESS;
 }
@@ -45,6 +45,18 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/* Optional build configuration, named on the command line with e.g.
+ * -DBOOT_RECORD_CONFIG_HEADER=\"soc_bootrecord.h\". It may define
+ * BOOT_RECORD_TIMESTAMP() or BOOT_RECORD_COUNTER() to read the time inline
+ * instead of through the weak hooks, see boot_record_timestamp */
+#ifdef BOOT_RECORD_CONFIG_HEADER
+#include BOOT_RECORD_CONFIG_HEADER
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* ========================================================================== */
 /*                           Macros & Typedefs                                */
 /* ========================================================================== */
@@ -64,6 +76,250 @@ typedef int32_t boot_record_status_t;
 #define BOOT_RECORD_ERR_INSUFFICIENT_MEM    (-2)
 /* Record limit exceded */
 #define BOOT_RECORD_ERR_OVERFLOW            (-3)
+/* Record slot reserved but not yet committed */
+#define BOOT_RECORD_ERR_PENDING             (-4)
+/* Data is not a boot stage of a supported format */
+#define BOOT_RECORD_ERR_FORMAT              (-5)
+
+/**
+ * Identification of a boot stage header, "BREC" in memory on little endian
+ */
+#define BOOT_RECORD_MAGIC                   (0x43455242U)
+
+/**
+ * Version of the boot stage layout, raised on every incompatible change
+ */
+#define BOOT_RECORD_FORMAT_VERSION          (1U)
+
+/**
+ * Byte orders, stored in boot_stage_record_t::byte_order
+ */
+#define BOOT_RECORD_BYTE_ORDER_LITTLE       (0U)
+#define BOOT_RECORD_BYTE_ORDER_BIG          (1U)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define BOOT_RECORD_BYTE_ORDER              BOOT_RECORD_BYTE_ORDER_BIG
+#else
+#define BOOT_RECORD_BYTE_ORDER              BOOT_RECORD_BYTE_ORDER_LITTLE
+#endif
+
+/**
+ * Timestamp units, stored in boot_stage_record_t::time_unit
+ */
+/* Microseconds */
+#define BOOT_RECORD_TIME_US                 (0U)
+/* Raw counter ticks at boot_stage_record_t::tick_rate_hz */
+#define BOOT_RECORD_TIME_TICKS              (1U)
+
+/**
+ * Boot stage flags, stored in boot_stage_record_t::flags
+ */
+/* Slots are reserved atomically so several cores may log concurrently */
+#define BOOT_RECORD_FLAG_CONCURRENT         (1U << 0)
+/* Region is split into one sub-stage per CPU */
+#define BOOT_RECORD_FLAG_PER_CPU            (1U << 1)
+/* Records hold an interned name ID instead of a copy of the name */
+#define BOOT_RECORD_FLAG_NAME_IDS           (1U << 2)
+/* Once full, new records overwrite the oldest ones */
+#define BOOT_RECORD_FLAG_RING               (1U << 3)
+/* Only the headers are cleared at init, unused slots keep stale data.
+ * With BOOT_RECORD_FLAG_CONCURRENT the commit marker of every slot is still
+ * cleared, which touches the whole record area */
+#define BOOT_RECORD_FLAG_LAZY_INIT          (1U << 4)
+/* Records are packed into 8 bytes, see boot_record_compact_profile_t.
+ * Requires BOOT_RECORD_FLAG_NAME_IDS and logs profile points only */
+#define BOOT_RECORD_FLAG_COMPACT            (1U << 5)
+/* Records are appended to a delta encoded byte stream, see
+ * boot_record_stream_block_t. Requires BOOT_RECORD_FLAG_NAME_IDS and one
+ * writer per stage or sub-stage, logs profile points only */
+#define BOOT_RECORD_FLAG_STREAM             (1U << 6)
+/* Name IDs index the site table of the firmware image, see
+ * boot_record_site_t, and the stage has no name table. Requires
+ * BOOT_RECORD_FLAG_NAME_IDS */
+#define BOOT_RECORD_FLAG_SITE_IDS           (1U << 7)
+
+/**
+ * Size of a profile name including the null terminator
+ */
+#define BOOT_RECORD_NAME_LEN                (24U)
+
+/**
+ * Largest number of names in a name table
+ */
+#define BOOT_RECORD_MAX_NAMES               (0xFFFFU)
+
+/**
+ * Name ID reported for records that store their name inline
+ */
+#define BOOT_RECORD_NAME_ID_NONE            (0xFFFFFFFFU)
+
+/**
+ * ELF section holding the site table, one boot_record_site_t per entry
+ *
+ * The name is a C identifier, so GNU linkers define __start_bootrecord_sites
+ * and __stop_bootrecord_sites around the orphan section. A linker script
+ * that places the section itself must KEEP it and define both symbols.
+ */
+#define BOOT_RECORD_SITE_SECTION            "bootrecord_sites"
+
+/**
+ * Define a site table entry for a profile point at the current source line
+ *
+ * The alignment is given explicitly, as compilers may otherwise align
+ * larger objects further and leave gaps between entries.
+ *
+ * \param var Name of the static entry
+ * \param literal String literal naming the profile point, of any length
+ */
+#define BOOT_RECORD_SITE_DEFINE(var, literal) \
+    static const boot_record_site_t var \
+        __attribute__((section(BOOT_RECORD_SITE_SECTION), used, \
+                       aligned(sizeof(void *)))) = \
+        { (literal), __FILE__, __LINE__ }
+
+/**
+ * Log a profile point by its site, see boot_record_log_site
+ *
+ * \param literal String literal naming the profile point, of any length
+ */
+#define BOOT_RECORD_LOG_SITE(literal) \
+    do { \
+        BOOT_RECORD_SITE_DEFINE(boot_record_site_, literal); \
+        (void)boot_record_log_site(&boot_record_site_); \
+    } while (0)
+
+/**
+ * Open a span by its site, see boot_record_begin_site
+ *
+ * \param literal String literal naming the span, of any length
+ */
+#define BOOT_RECORD_BEGIN_SITE(literal) \
+    do { \
+        BOOT_RECORD_SITE_DEFINE(boot_record_site_, literal); \
+        (void)boot_record_begin_site(&boot_record_site_); \
+    } while (0)
+
+/**
+ * Log a profile point by its site to a context
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param literal String literal naming the profile point, of any length
+ */
+#define BOOT_RECORD_CTX_LOG_SITE(ctx, literal) \
+    do { \
+        BOOT_RECORD_SITE_DEFINE(boot_record_site_, literal); \
+        (void)boot_record_ctx_log_site((ctx), &boot_record_site_); \
+    } while (0)
+
+/**
+ * Fields of boot_record_id_profile_t::info
+ */
+/* Record is completely written, used in concurrent mode */
+#define BOOT_RECORD_INFO_COMMIT             (1U << 31)
+/* Record kind (BOOT_RECORD_KIND_*) */
+#define BOOT_RECORD_INFO_KIND_SHIFT         (29U)
+#define BOOT_RECORD_INFO_KIND_MASK          (0x3U)
+/* Nesting depth of a span record */
+#define BOOT_RECORD_INFO_DEPTH_SHIFT        (23U)
+#define BOOT_RECORD_INFO_DEPTH_MASK         (0x3FU)
+/* Distance back to the linked record, 0 for none. A begin record links to
+ * the begin of its enclosing span, an end record to its own begin. A wait
+ * record holds the name ID of the awaited record instead */
+#define BOOT_RECORD_INFO_LINK_MASK          (0x7FFFFFU)
+
+/**
+ * Encode the kind, depth and link fields of boot_record_id_profile_t::info
+ */
+#define BOOT_RECORD_INFO(kind, depth, link) \
+    (((uint32_t)(kind) << BOOT_RECORD_INFO_KIND_SHIFT) | \
+     ((uint32_t)(depth) << BOOT_RECORD_INFO_DEPTH_SHIFT) | \
+     ((uint32_t)(link) & BOOT_RECORD_INFO_LINK_MASK))
+
+/**
+ * Fields of boot_record_compact_profile_t::data
+ */
+/* Signed offset of the timestamp from boot_stage_record_t::start_time */
+#define BOOT_RECORD_COMPACT_TIME_SHIFT      (16U)
+#define BOOT_RECORD_COMPACT_TIME_BITS       (48U)
+/* Name ID + 1, 0 while the slot is not written */
+#define BOOT_RECORD_COMPACT_NAME_MASK       (0xFFFFU)
+
+/**
+ * Size of one block of a record stream, the stride of a stream stage
+ */
+#define BOOT_RECORD_STREAM_BLOCK_SIZE       (256U)
+
+/**
+ * Longest encoded stream record, a 3 byte name ID and a 10 byte delta
+ */
+#define BOOT_RECORD_STREAM_RECORD_MAX       (13U)
+
+/**
+ * Record kinds
+ */
+/* Single point in time */
+#define BOOT_RECORD_KIND_POINT              (0U)
+/* Start of a span */
+#define BOOT_RECORD_KIND_BEGIN              (1U)
+/* End of a span */
+#define BOOT_RECORD_KIND_END                (2U)
+/* Point reached once another record, possibly of another CPU, was logged */
+#define BOOT_RECORD_KIND_WAIT               (3U)
+
+/**
+ * Deepest span nesting supported
+ */
+#define BOOT_RECORD_MAX_SPAN_DEPTH          (BOOT_RECORD_INFO_DEPTH_MASK + 1U)
+
+/**
+ * Index reported when a linked record does not exist
+ */
+#define BOOT_RECORD_INDEX_NONE              (0xFFFFFFFFU)
+
+/**
+ * Magic value identifying a boot record chain ("BRCH")
+ */
+#define BOOT_RECORD_CHAIN_MAGIC             (0x48435242U)
+
+/**
+ * Number of stages a boot record chain can hold
+ */
+#define BOOT_RECORD_MAX_STAGES              (16U)
+
+/**
+ * Target rates for boot_record_tconv_init
+ */
+/* Microseconds */
+#define BOOT_RECORD_UNIT_US                 (1000000U)
+/* Nanoseconds */
+#define BOOT_RECORD_UNIT_NS                 (1000000000U)
+
+/**
+ * Number of entries in the name lookup cache, must be a power of two
+ */
+#ifndef BOOT_RECORD_NAME_CACHE_SIZE
+#define BOOT_RECORD_NAME_CACHE_SIZE         (32U)
+#endif
+
+/**
+ * Alignment of per-CPU sub-stages, keeps cores off each other's cache lines
+ */
+#ifndef BOOT_RECORD_CACHE_LINE_SIZE
+#define BOOT_RECORD_CACHE_LINE_SIZE         (64U)
+#endif
+
+/**
+ * Maximum number of CPUs supported by the per-CPU layout
+ */
+#ifndef BOOT_RECORD_MAX_CPUS
+#define BOOT_RECORD_MAX_CPUS                (16U)
+#endif
+
+/**
+ * Commit marker stored in the last byte of boot_record_profile_t::name
+ * once a concurrently logged record is complete
+ */
+#define BOOT_RECORD_COMMIT_MARK             (0xA5U)
 
 /* ========================================================================== */
 /*                           Data Structures                                  */
@@ -75,28 +331,140 @@ typedef int32_t boot_record_status_t;
 typedef struct
 {
     /* Name of the record profile */
-    char name[24];
+    char name[BOOT_RECORD_NAME_LEN];
     /* Time measurement for this profile */
     uint64_t time;
 } boot_record_profile_t;
 
+/**
+ * Profile record referring to its name through the name table
+ */
+typedef struct
+{
+    /* Index of the name in the name table */
+    uint32_t name_id;
+    /* Record attributes (BOOT_RECORD_INFO_*) */
+    uint32_t info;
+    /* Time measurement for this profile */
+    uint64_t time;
+} boot_record_id_profile_t;
+
+/**
+ * Profile record packed into 8 bytes (BOOT_RECORD_FLAG_COMPACT)
+ *
+ * Holds a 16-bit name field and a 48-bit timestamp offset, so it covers
+ * 2^47 time units on either side of the stage start. The record is written
+ * with a single store, which also publishes it in concurrent mode.
+ */
+typedef struct
+{
+    /* Timestamp offset and name (BOOT_RECORD_COMPACT_*) */
+    uint64_t data;
+} boot_record_compact_profile_t;
+
+/**
+ * Name and call site of a profile point (BOOT_RECORD_FLAG_SITE_IDS)
+ *
+ * Entries are placed in BOOT_RECORD_SITE_SECTION by BOOT_RECORD_SITE_DEFINE
+ * and never read by the firmware, which logs the index of an entry in the
+ * section as its name ID. The host reads the names from the ELF file.
+ */
+typedef struct
+{
+    /* Name of the profile point */
+    const char *name;
+    /* Source file of the call site */
+    const char *file;
+    /* Source line of the call site */
+    uint32_t line;
+} boot_record_site_t;
+
+/**
+ * Sync point starting each block of a record stream (BOOT_RECORD_FLAG_STREAM)
+ *
+ * It is followed by count records, each the name ID and the time since the
+ * previous record of the block as LEB128 varints. The first record counts
+ * from time. Records never straddle two blocks, so every block decodes on
+ * its own and a record is found by its index without reading earlier blocks.
+ */
+typedef struct
+{
+    /* Absolute timestamp the first delta of the block is relative to */
+    uint64_t time;
+    /* Logging-order index of the first record of the block */
+    uint32_t first;
+    /* Number of records in the block */
+    uint32_t count;
+} boot_record_stream_block_t;
+
 /**
  * Boot stage record structure
+ *
+ * The first 16 bytes describe the layout, so a reader built for another
+ * CPU can check that it decodes the stage the way it was written. Only
+ * fixed size fields are used, so the layout is the same for 32-bit and
+ * 64-bit CPUs of the same byte order.
  */
 typedef struct
 {
+    /* BOOT_RECORD_MAGIC */
+    uint32_t magic;
+    /* BOOT_RECORD_FORMAT_VERSION of the writer */
+    uint16_t version;
+    /* Size of this header, the offset of the first profile record */
+    uint16_t header_size;
+    /* Size of one profile record */
+    uint16_t record_stride;
+    /* BOOT_RECORD_NAME_LEN of the writer */
+    uint8_t name_len;
+    /* Unit of the timestamps (BOOT_RECORD_TIME_*) */
+    uint8_t time_unit;
+    /* Byte order of the writer (BOOT_RECORD_BYTE_ORDER_*) */
+    uint8_t byte_order;
+    /* Reserved, must be zero */
+    uint8_t reserved0[3];
     /* Unique identifier for this record */
     uint32_t record_id;
     /* Count of profile records in this boot stage */
     uint32_t record_count;
     /* Start time of this boot stage */
     uint64_t start_time;
+    /* Boot stage flags (BOOT_RECORD_FLAG_*) */
+    uint32_t flags;
+    /* Number of profile records that fit in this boot stage */
+    uint32_t possible_records;
+    /* Number of per-CPU sub-stages, 0 when not split per CPU */
+    uint32_t cpu_count;
+    /* Offset of the first per-CPU sub-stage from this header */
+    uint32_t cpu_offset;
+    /* Distance in bytes between consecutive per-CPU sub-stages */
+    uint32_t cpu_stride;
+    /* Offset of the name table from this header, 0 without name IDs or
+     * with site IDs */
+    uint32_t name_offset;
+    /* Number of BOOT_RECORD_NAME_LEN sized slots in the name table, or of
+     * site table entries with site IDs */
+    uint32_t name_capacity;
+    /* Number of names interned so far */
+    uint32_t name_count;
+    /* Rate of the raw timestamp counter in Hz, 0 for microseconds */
+    uint32_t tick_rate_hz;
+    /* Slot of the oldest profile record in ring mode */
+    uint32_t head;
+    /* Number of profile records overwritten in ring mode */
+    uint32_t lost_count;
+    /* Bytes of the record stream written with BOOT_RECORD_FLAG_STREAM */
+    uint32_t stream_size;
     /* Array of profile records */
     boot_record_profile_t profiles[0];
 } boot_stage_record_t;
 
 /**
  * Complete boot records data structure
+ *
+ * Also serves as the context of the boot_record_ctx_* functions. Each
+ * context logs into its own memory area; the other logging functions use a
+ * default context inside the library.
  */
 typedef struct
 {
@@ -108,20 +476,192 @@ typedef struct
     uint32_t possible_records;
     /* Array of boot stage records */
     boot_stage_record_t *records;
+    /* Recently looked up name pointers */
+    const char *name_cache[BOOT_RECORD_NAME_CACHE_SIZE];
+    /* Name IDs of the cached name pointers */
+    uint32_t name_cache_id[BOOT_RECORD_NAME_CACHE_SIZE];
+    /* Stage or per-CPU sub-stage boot_record_scrub is working on */
+    uint32_t scrub_stage;
+    /* Slot below which boot_record_scrub still has to clear */
+    uint32_t scrub_slot;
+    /* Record number + 1 of the innermost open span, 0 for none, per CPU */
+    uint32_t span_open[BOOT_RECORD_MAX_CPUS];
+    /* Number of open spans, per CPU */
+    uint32_t span_depth[BOOT_RECORD_MAX_CPUS];
+    /* Timestamp of the last stream record, per CPU */
+    uint64_t stream_time[BOOT_RECORD_MAX_CPUS];
 } boot_records_t;
 
+/**
+ * Location of one boot stage in a boot record chain
+ */
+typedef struct
+{
+    /* Offset of the boot stage record from the chain header */
+    uint32_t offset;
+    /* Size in bytes of the memory given to the boot stage */
+    uint32_t size;
+} boot_record_chain_entry_t;
+
+/**
+ * Table of contents of boot stages sharing one memory region
+ */
+typedef struct
+{
+    /* BOOT_RECORD_CHAIN_MAGIC once the chain is created */
+    uint32_t magic;
+    /* Size of the whole memory region */
+    uint32_t size;
+    /* Offset of the first free byte after the last boot stage */
+    uint32_t tail_offset;
+    /* Number of boot stages in the chain */
+    uint32_t stage_count;
+    /* Boot stages in the order they were appended */
+    boot_record_chain_entry_t stages[BOOT_RECORD_MAX_STAGES];
+} boot_record_chain_t;
+
+/**
+ * Optional boot record initialization parameters
+ */
+typedef struct
+{
+    /* Boot stage flags (BOOT_RECORD_FLAG_*) */
+    uint32_t flags;
+    /* Number of CPUs when BOOT_RECORD_FLAG_PER_CPU is set */
+    uint32_t num_cpus;
+    /* Number of name table slots when BOOT_RECORD_FLAG_NAME_IDS is set,
+     * unused with BOOT_RECORD_FLAG_SITE_IDS */
+    uint32_t name_capacity;
+    /* Rate in Hz of the raw counter returned by boot_record_get_timestamp,
+     * 0 if it already returns microseconds */
+    uint32_t tick_rate_hz;
+} boot_record_params_t;
+
+/**
+ * Precomputed multiply/shift conversion from stage timestamps to a time unit
+ */
+typedef struct
+{
+    /* Multiplier applied to the timestamp */
+    uint32_t mult;
+    /* Right shift applied after the multiplication */
+    uint32_t shift;
+} boot_record_tconv_t;
+
+/**
+ * Decoded profile record, tagged with the CPU that logged it
+ */
+typedef struct
+{
+    /* CPU that logged the record */
+    uint32_t cpu_id;
+    /* Name ID, BOOT_RECORD_NAME_ID_NONE for records with inline names */
+    uint32_t name_id;
+    /* Name of the profile point in place, NULL if unknown */
+    const char *name;
+    /* Record kind (BOOT_RECORD_KIND_*) */
+    uint32_t kind;
+    /* Nesting depth of a span record */
+    uint32_t depth;
+    /* Index of the linked begin record, BOOT_RECORD_INDEX_NONE if none */
+    uint32_t link;
+    /* Name ID of the record a wait record waited for,
+     * BOOT_RECORD_NAME_ID_NONE for other kinds */
+    uint32_t wait_id;
+    /* Time measurement for this profile */
+    uint64_t time;
+} boot_record_event_t;
+
+/**
+ * Span reconstructed from a pair of begin and end records
+ */
+typedef struct
+{
+    /* CPU that logged the span */
+    uint32_t cpu_id;
+    /* Name ID of the span */
+    uint32_t name_id;
+    /* Name of the span in place, NULL if unknown */
+    const char *name;
+    /* Nesting depth, 0 for top-level spans */
+    uint32_t depth;
+    /* Index of the begin record */
+    uint32_t begin_index;
+    /* Index of the end record */
+    uint32_t end_index;
+    /* Index of the begin record of the enclosing span, or
+     * BOOT_RECORD_INDEX_NONE */
+    uint32_t parent_index;
+    /* Time of the begin record */
+    uint64_t start_time;
+    /* Time from begin to end */
+    uint64_t inclusive_time;
+    /* Inclusive time minus the inclusive time of direct child spans */
+    uint64_t exclusive_time;
+} boot_record_span_t;
+
+/**
+ * Callback receiving reconstructed spans
+ */
+typedef void (*boot_record_span_fn)(const boot_record_span_t *span, void *arg);
+
+/**
+ * Zero-copy view of the profile records of a stage in logging order
+ *
+ * Records are boot_record_get_stride() bytes apart. In ring mode the oldest
+ * records run from the head to the end of the array and the rest continue
+ * from its start.
+ */
+typedef struct
+{
+    /* Oldest profile records */
+    const void *first;
+    /* Number of records in the first segment */
+    uint32_t first_count;
+    /* Newer profile records continuing the first segment */
+    const void *second;
+    /* Number of records in the second segment */
+    uint32_t second_count;
+} boot_record_view_t;
+
+/**
+ * Callback receiving merged profile records in time order
+ */
+typedef void (*boot_record_merge_fn)(const boot_record_event_t *event,
+                                     void *arg);
+
 /* ========================================================================== */
 /*                          External Functions                                */
 /* ========================================================================== */
 
 /**
  * Get current timestamp - platform-dependent implementation
- * To be implemented by user for their specific platform
+ * To be implemented by user for their specific platform, unless
+ * boot_record_get_counter is implemented instead
  *
- * \return Current timestamp value in microseconds
+ * \return Current timestamp value in microseconds, or raw counter ticks when
+ *         the stage is initialized with a non-zero tick_rate_hz
  */
 __attribute__((weak)) uint64_t boot_record_get_timestamp(void);
 
+/**
+ * Get a free-running 32-bit counter - platform-dependent implementation
+ * Only used when boot_record_get_timestamp is not implemented
+ *
+ * The library extends the counter to 64 bits, see boot_record_timestamp.
+ *
+ * \return Raw counter value, wrapping from 0xFFFFFFFF to 0
+ */
+__attribute__((weak)) uint32_t boot_record_get_counter(void);
+
+/**
+ * Get the index of the calling CPU - platform-dependent implementation
+ * Only needed with BOOT_RECORD_FLAG_PER_CPU
+ *
+ * \return Index of the current CPU, from 0 to num_cpus - 1
+ */
+__attribute__((weak)) uint32_t boot_record_get_cpu_id(void);
+
 /* ========================================================================== */
 /*                          Function Declarations                             */
 /* ========================================================================== */
@@ -138,6 +678,75 @@ boot_record_status_t boot_record_init(uint32_t stage_id,
                                      void *memory_addr,
                                      uint32_t size);
 
+/**
+ * Get the current timestamp, as records are stamped with it
+ *
+ * Returns BOOT_RECORD_TIMESTAMP() if the config header defines it, else
+ * boot_record_get_timestamp if implemented, else BOOT_RECORD_COUNTER() or
+ * boot_record_get_counter extended to 64 bits. With a macro the weak hooks
+ * are not used and the read is inlined into every logging function.
+ *
+ * The extension counts the half periods of the counter in one word updated
+ * with a 32-bit compare-and-swap, so it is safe against interrupts and
+ * other cores sharing the counter. It must be called at least once every
+ * 2^31 ticks; if a stage can be idle longer, call it from a periodic
+ * interrupt. The count starts at 0 in every image.
+ *
+ * \return Current timestamp value
+ */
+uint64_t boot_record_timestamp(void);
+
+/**
+ * Set boot record initialization parameters to their defaults
+ *
+ * \param params Parameters to initialize
+ */
+void boot_record_params_init(boot_record_params_t *params);
+
+/**
+ * Initialize the boot records system with explicit parameters
+ *
+ * \param stage_id ID for this boot stage
+ * \param memory_addr Base address for records storage
+ * \param size Size of allocated memory
+ * \param params Initialization parameters, NULL for defaults
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_init_ex(uint32_t stage_id,
+                                        void *memory_addr,
+                                        uint32_t size,
+                                        const boot_record_params_t *params);
+
+/**
+ * Create an empty boot record chain in a shared memory region
+ *
+ * Called once by the first boot stage using the region. Only the chain
+ * header is written.
+ *
+ * \param memory_addr Base address of the shared region
+ * \param size Size of the shared region
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_chain_create(void *memory_addr, uint32_t size);
+
+/**
+ * Initialize the boot records system in a new stage appended to a chain
+ *
+ * The stage is placed at the chain's tail, so the records of earlier
+ * stages are kept.
+ *
+ * \param stage_id ID for this boot stage
+ * \param memory_addr Base address of the shared region holding the chain
+ * \param stage_size Bytes to give to this stage, 0 for all remaining space
+ * \param params Initialization parameters, NULL for defaults
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_OVERFLOW if the
+ *         chain has no free entry, error code on failure
+ */
+boot_record_status_t boot_record_chain_init(uint32_t stage_id,
+                                           void *memory_addr,
+                                           uint32_t stage_size,
+                                           const boot_record_params_t *params);
+
 /**
  * Log a profile record with the current timestamp
  *
@@ -145,4 +754,471 @@ boot_record_status_t boot_record_init(uint32_t stage_id,
  * \return BOOT_RECORD_SUCCESS on success, error code on failure
  */
 boot_record_status_t boot_record_log_profile(const char *name);
+
+/**
+ * Clear part of the unused record slots left stale by a lazy init
+ *
+ * Works downwards from the end of each stage towards its last record, at
+ * most max_bytes per call, so it can run from an idle loop. Call it from
+ * the core that logs, or once other cores have stopped logging.
+ *
+ * \param max_bytes Maximum number of bytes to clear in this call, at least
+ *        one record slot (record_stride)
+ * \return BOOT_RECORD_SUCCESS once all unused slots are clear,
+ *         BOOT_RECORD_ERR_PENDING if more calls are needed,
+ *         BOOT_RECORD_ERR_INVALID_PARAMS if max_bytes is smaller than a
+ *         slot, error code on failure
+ */
+boot_record_status_t boot_record_scrub(uint32_t max_bytes);
+
+/**
+ * Intern a profile name and get its name ID
+ *
+ * Requires BOOT_RECORD_FLAG_NAME_IDS. Registering the same name again
+ * returns the ID it already has.
+ *
+ * \param name Name of the profile point
+ * \param name_id Pointer to receive the name ID
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_OVERFLOW if the
+ *         name table is full, error code on failure
+ */
+boot_record_status_t boot_record_register_name(const char *name,
+                                              uint32_t *name_id);
+
+/**
+ * Log a profile record for a registered name ID with the current timestamp
+ *
+ * \param name_id Name ID returned by boot_record_register_name
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_log_id(uint32_t name_id);
+
+/**
+ * Open a span with the current timestamp
+ *
+ * Requires BOOT_RECORD_FLAG_NAME_IDS and no BOOT_RECORD_FLAG_COMPACT or
+ * BOOT_RECORD_FLAG_STREAM. The begin record stores its nesting depth and a
+ * link to the enclosing span of the calling CPU. With
+ * BOOT_RECORD_FLAG_CONCURRENT spans need boot_record_get_cpu_id to tell the
+ * cores apart and fail without it.
+ *
+ * \param name Name of the span
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_OVERFLOW if
+ *         spans are nested deeper than BOOT_RECORD_MAX_SPAN_DEPTH, error code
+ *         on failure
+ */
+boot_record_status_t boot_record_begin(const char *name);
+
+/**
+ * Open a span for a registered name ID with the current timestamp
+ *
+ * \param name_id Name ID returned by boot_record_register_name
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_begin_id(uint32_t name_id);
+
+/**
+ * Close the innermost open span of the calling CPU
+ *
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_INVALID_PARAMS if
+ *         no span is open, error code on failure
+ */
+boot_record_status_t boot_record_end(void);
+
+/**
+ * Log that a point was reached after waiting for another record
+ *
+ * Requires BOOT_RECORD_FLAG_NAME_IDS and no BOOT_RECORD_FLAG_COMPACT. Call
+ * it once the wait is over, e.g. when a core continues after another core
+ * logged the awaited name. The awaited record is found by name by the
+ * reader, so it may be logged on any CPU and in an earlier stage of a
+ * chain.
+ *
+ * \param name Name of the point reached
+ * \param waited_on Name of the record waited for
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_wait(const char *name, const char *waited_on);
+
+/**
+ * Log a wait record for registered name IDs with the current timestamp
+ *
+ * \param name_id Name ID of the point reached
+ * \param wait_id Name ID of the record waited for
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_wait_id(uint32_t name_id, uint32_t wait_id);
+
+/**
+ * Get the name ID of a site table entry
+ *
+ * \param site Entry defined by BOOT_RECORD_SITE_DEFINE
+ * \return Index of the entry in the site table, BOOT_RECORD_NAME_ID_NONE if
+ *         the entry is not part of it
+ */
+uint32_t boot_record_site_id(const boot_record_site_t *site);
+
+/**
+ * Log a profile record for a site with the current timestamp
+ *
+ * Requires BOOT_RECORD_FLAG_SITE_IDS. Only the index of the site is logged,
+ * no string is read or copied.
+ *
+ * \param site Entry defined by BOOT_RECORD_SITE_DEFINE
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_log_site(const boot_record_site_t *site);
+
+/**
+ * Open a span for a site with the current timestamp
+ *
+ * Requires BOOT_RECORD_FLAG_SITE_IDS, see boot_record_begin_id.
+ *
+ * \param site Entry defined by BOOT_RECORD_SITE_DEFINE
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_begin_site(const boot_record_site_t *site);
+
+/**
+ * Initialize a boot record context
+ *
+ * Contexts are independent of each other and of the default context, for
+ * example to keep the records of an interrupt-heavy subsystem apart from
+ * those of the main loop. A context is owned by the caller; the library
+ * never allocates memory for it.
+ *
+ * \param ctx Context to initialize
+ * \param stage_id ID for this boot stage
+ * \param memory_addr Base address for records storage
+ * \param size Size of allocated memory
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_init(boot_records_t *ctx,
+                                         uint32_t stage_id,
+                                         void *memory_addr,
+                                         uint32_t size);
+
+/**
+ * Initialize a boot record context with explicit parameters
+ *
+ * \param ctx Context to initialize
+ * \param stage_id ID for this boot stage
+ * \param memory_addr Base address for records storage
+ * \param size Size of allocated memory
+ * \param params Initialization parameters, NULL for defaults
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_init_ex(boot_records_t *ctx,
+                                            uint32_t stage_id,
+                                            void *memory_addr,
+                                            uint32_t size,
+                                            const boot_record_params_t *params);
+
+/**
+ * Initialize a boot record context in a new stage appended to a chain
+ *
+ * \param ctx Context to initialize
+ * \param stage_id ID for this boot stage
+ * \param memory_addr Base address of the shared region holding the chain
+ * \param stage_size Bytes to give to this stage, 0 for all remaining space
+ * \param params Initialization parameters, NULL for defaults
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_OVERFLOW if the
+ *         chain has no free entry, error code on failure
+ */
+boot_record_status_t boot_record_ctx_chain_init(boot_records_t *ctx,
+                                               uint32_t stage_id,
+                                               void *memory_addr,
+                                               uint32_t stage_size,
+                                               const boot_record_params_t *params);
+
+/**
+ * Log a profile record to a context with the current timestamp
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param name Name of the profile point
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_log(boot_records_t *ctx, const char *name);
+
+/**
+ * Clear part of the unused record slots of a context left stale by a lazy init
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param max_bytes Maximum number of bytes to clear in this call, at least
+ *        one record slot (record_stride)
+ * \return BOOT_RECORD_SUCCESS once all unused slots are clear,
+ *         BOOT_RECORD_ERR_PENDING if more calls are needed,
+ *         BOOT_RECORD_ERR_INVALID_PARAMS if max_bytes is smaller than a
+ *         slot, error code on failure
+ */
+boot_record_status_t boot_record_ctx_scrub(boot_records_t *ctx, uint32_t max_bytes);
+
+/**
+ * Intern a profile name in a context and get its name ID
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param name Name of the profile point
+ * \param name_id Pointer to receive the name ID, valid for this context only
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_OVERFLOW if the
+ *         name table is full, error code on failure
+ */
+boot_record_status_t boot_record_ctx_register_name(boot_records_t *ctx,
+                                                  const char *name,
+                                                  uint32_t *name_id);
+
+/**
+ * Log a profile record for a registered name ID to a context
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param name_id Name ID returned by boot_record_ctx_register_name
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_log_id(boot_records_t *ctx, uint32_t name_id);
+
+/**
+ * Log a profile record for a site to a context
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param site Entry defined by BOOT_RECORD_SITE_DEFINE
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_log_site(boot_records_t *ctx,
+                                             const boot_record_site_t *site);
+
+/**
+ * Open a span in a context with the current timestamp
+ *
+ * Spans nest per context and per CPU.
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param name Name of the span
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_OVERFLOW if
+ *         spans are nested deeper than BOOT_RECORD_MAX_SPAN_DEPTH, error code
+ *         on failure
+ */
+boot_record_status_t boot_record_ctx_begin(boot_records_t *ctx, const char *name);
+
+/**
+ * Open a span in a context for a registered name ID
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param name_id Name ID returned by boot_record_ctx_register_name
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_begin_id(boot_records_t *ctx, uint32_t name_id);
+
+/**
+ * Open a span in a context for a site
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param site Entry defined by BOOT_RECORD_SITE_DEFINE
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_begin_site(boot_records_t *ctx,
+                                               const boot_record_site_t *site);
+
+/**
+ * Close the innermost open span of the calling CPU in a context
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_INVALID_PARAMS if
+ *         no span is open, error code on failure
+ */
+boot_record_status_t boot_record_ctx_end(boot_records_t *ctx);
+
+/**
+ * Log a wait record to a context, see boot_record_wait
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param name Name of the point reached
+ * \param waited_on Name of the record waited for
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_wait(boot_records_t *ctx, const char *name,
+                                          const char *waited_on);
+
+/**
+ * Log a wait record for registered name IDs to a context
+ *
+ * \param ctx Context initialized by boot_record_ctx_init
+ * \param name_id Name ID of the point reached
+ * \param wait_id Name ID of the record waited for
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_ctx_wait_id(boot_records_t *ctx, uint32_t name_id,
+                                             uint32_t wait_id);
+
+/**
+ * Check that memory holds a boot stage this build can read in place
+ *
+ * Checks the layout descriptor of the stage and of its per-CPU sub-stages,
+ * and that their records and name table lie within size bytes. The work
+ * does not depend on the number of records. On success the other reader
+ * functions can be used on the stage directly, without copying it.
+ *
+ * \param memory_addr Start of the stage, 8-byte aligned
+ * \param size Number of readable bytes at memory_addr
+ * \param stage Pointer to receive the stage
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_FORMAT if the
+ *         memory does not hold a stage of this format version and byte
+ *         order, the stage does not fit, or a stage without
+ *         BOOT_RECORD_FLAG_PER_CPU has per-CPU fields set, error code on
+ *         failure
+ */
+boot_record_status_t boot_record_validate(const void *memory_addr,
+                                         uint32_t size,
+                                         const boot_stage_record_t **stage);
+
+/**
+ * Get the number of profile records that can be read from a boot stage
+ *
+ * \param stage Boot stage record to read from
+ * \return Number of readable profile records
+ */
+uint32_t boot_record_get_count(const boot_stage_record_t *stage);
+
+/**
+ * Get the size in bytes of one profile slot of a boot stage
+ *
+ * \param stage Boot stage record to read from
+ * \return Size of a profile slot, or of a block of a record stream
+ */
+uint32_t boot_record_get_stride(const boot_stage_record_t *stage);
+
+/**
+ * Get a completely written profile record from a boot stage
+ *
+ * Only valid for stages storing inline names, see boot_record_get_event
+ * for stages using name IDs.
+ *
+ * \param stage Boot stage record to read from
+ * \param index Index of the profile record in logging order
+ * \param profile Pointer set to the profile record in place
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_PENDING if the
+ *         slot is still being written, error code on failure
+ */
+boot_record_status_t boot_record_get_profile(const boot_stage_record_t *stage,
+                                            uint32_t index,
+                                            const boot_record_profile_t **profile);
+
+/**
+ * Decode a completely written profile record of any layout
+ *
+ * A stream record is located through the sync points of the blocks and
+ * decoded from the start of its block.
+ *
+ * \param stage Boot stage record to read from
+ * \param index Index of the profile record in logging order
+ * \param event Pointer to receive the decoded record, cpu_id is set to 0
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_PENDING if the
+ *         slot is still being written, error code on failure
+ */
+boot_record_status_t boot_record_get_event(const boot_stage_record_t *stage,
+                                          uint32_t index,
+                                          boot_record_event_t *event);
+
+/**
+ * Get the profile records of a stage in logging order without copying
+ *
+ * Not available for record streams, whose records have no fixed size.
+ *
+ * \param stage Boot stage record or per-CPU sub-stage to read from
+ * \param view Pointer to receive the one or two record segments
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_get_view(const boot_stage_record_t *stage,
+                                         boot_record_view_t *view);
+
+/**
+ * Compute inclusive and exclusive time of every span of a stage
+ *
+ * Makes one linear pass over the records, keeping only the open spans.
+ * Spans are reported when they end, so children come before their parent.
+ * Spans whose begin or end record is missing are not reported.
+ *
+ * \param stage Boot stage record to read from
+ * \param fn Callback invoked once per complete span
+ * \param arg Opaque argument passed to fn
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_OVERFLOW if more
+ *         than BOOT_RECORD_MAX_SPAN_DEPTH spans are open at once, error code
+ *         on failure
+ */
+boot_record_status_t boot_record_analyze_spans(const boot_stage_record_t *stage,
+                                              boot_record_span_fn fn,
+                                              void *arg);
+
+/**
+ * Look up a name in the name table of a boot stage
+ *
+ * \param stage Boot stage record or per-CPU sub-stage to read from
+ * \param name_id Name ID to look up
+ * \return Null-terminated name in place, NULL if the ID is not in use
+ */
+const char *boot_record_get_name(const boot_stage_record_t *stage,
+                                 uint32_t name_id);
+
+/**
+ * Prepare conversion of a stage's timestamps to a time unit
+ *
+ * Computes a multiplier and shift once so that each conversion is a
+ * multiply and shift instead of a 64-bit division.
+ *
+ * \param conv Converter to initialize
+ * \param stage Boot stage record whose timestamps will be converted
+ * \param unit_hz Target rate, e.g. BOOT_RECORD_UNIT_US or BOOT_RECORD_UNIT_NS
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_tconv_init(boot_record_tconv_t *conv,
+                                           const boot_stage_record_t *stage,
+                                           uint32_t unit_hz);
+
+/**
+ * Convert a stage timestamp with a prepared converter
+ *
+ * \param conv Converter prepared by boot_record_tconv_init
+ * \param time Timestamp or time difference read from the stage
+ * \return Time in the converter's unit
+ */
+uint64_t boot_record_tconv_apply(const boot_record_tconv_t *conv, uint64_t time);
+
+/**
+ * Get a boot stage of a chain
+ *
+ * \param chain Boot record chain to read from
+ * \param index Index of the stage, in the order stages were appended
+ * \return Pointer to the boot stage record, NULL if out of range
+ */
+const boot_stage_record_t *boot_record_chain_get_stage(const boot_record_chain_t *chain,
+                                                       uint32_t index);
+
+/**
+ * Get the sub-stage holding the records of one CPU
+ *
+ * \param stage Boot stage record initialized with BOOT_RECORD_FLAG_PER_CPU
+ * \param cpu_id Index of the CPU
+ * \return Pointer to the per-CPU sub-stage, NULL if out of range
+ */
+const boot_stage_record_t *boot_record_get_cpu_stage(const boot_stage_record_t *stage,
+                                                     uint32_t cpu_id);
+
+/**
+ * Merge the records of all CPUs into one stream ordered by time
+ *
+ * Performs a k-way merge over the per-CPU sub-stages without copying or
+ * allocating. A stage that is not split per CPU is reported as CPU 0.
+ * Records still being written are skipped.
+ *
+ * \param stage Boot stage record to read from
+ * \param fn Callback invoked once per record in time order
+ * \param arg Opaque argument passed to fn
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_merge(const boot_stage_record_t *stage,
+                                      boot_record_merge_fn fn,
+                                      void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* BOOT_RECORD_H */
\ No newline at end of file
@@ -0,0 +1,234 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord.hpp
+ * \brief C++ scope recorder for the boot record logging library
+ *
+ * Names are hashed at compile time. Each distinct name is registered in the
+ * stage's name table the first time it is logged, after which logging costs
+ * one load of the cached name ID plus the record itself.
+ *
+ * Define BOOT_RECORD_DISABLE to 1 to compile all recording out.
+ */
+
+#ifndef BOOT_RECORD_HPP
+#define BOOT_RECORD_HPP
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bootrecord.h"
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+#ifndef BOOT_RECORD_DISABLE
+#define BOOT_RECORD_DISABLE                 (0)
+#endif
+
+#define BOOT_RECORD_CONCAT_(a, b)           a##b
+#define BOOT_RECORD_CONCAT(a, b)            BOOT_RECORD_CONCAT_(a, b)
+
+/* Unique per expansion, so several scopes may share a line or a wrapper
+ * macro. __LINE__ where the compiler lacks __COUNTER__ */
+#ifdef __COUNTER__
+#define BOOT_RECORD_UNIQUE                  __COUNTER__
+#else
+#define BOOT_RECORD_UNIQUE                  __LINE__
+#endif
+
+/**
+ * Check at compile time that a name is a string literal which fits in
+ * boot_record_profile_t::name, including the terminating NUL
+ */
+#define BOOT_RECORD_CHECK_NAME(literal) \
+    static_assert(::bootrecord::name_length(literal) < \
+                  sizeof(boot_record_profile_t::name), \
+                  "boot record name too long: " literal)
+
+#if BOOT_RECORD_DISABLE
+
+#define BOOT_RECORD_SCOPE(literal)          BOOT_RECORD_CHECK_NAME(literal)
+#define BOOT_RECORD_POINT(literal) \
+    do { BOOT_RECORD_CHECK_NAME(literal); } while (0)
+
+#else
+
+/**
+ * Record a span from this statement to the end of the enclosing scope
+ *
+ * \param literal String literal naming the span
+ */
+#define BOOT_RECORD_SCOPE(literal) \
+    BOOT_RECORD_CHECK_NAME(literal); \
+    ::bootrecord::ScopedBootRecord<::bootrecord::fnv1a(literal)> \
+        BOOT_RECORD_CONCAT(boot_record_scope_, BOOT_RECORD_UNIQUE)(literal)
+
+/**
+ * Record a single profile point
+ *
+ * \param literal String literal naming the profile point
+ */
+#define BOOT_RECORD_POINT(literal) \
+    do { \
+        BOOT_RECORD_CHECK_NAME(literal); \
+        (void)boot_record_log_id( \
+            ::bootrecord::NameId<::bootrecord::fnv1a(literal)>::get(literal)); \
+    } while (0)
+
+#endif
+
+namespace bootrecord {
+
+/* ========================================================================== */
+/*                           Name Hashing                                     */
+/* ========================================================================== */
+
+constexpr uint64_t kFnvOffsetBasis = 0xCBF29CE484222325ULL;
+constexpr uint64_t kFnvPrime = 0x00000100000001B3ULL;
+
+/**
+ * 64-bit FNV-1a hash of a NUL terminated string, usable at compile time
+ *
+ * \param s String to hash
+ * \param hash Hash of the characters before s
+ * \return Hash of the string
+ */
+constexpr uint64_t fnv1a(const char *s, uint64_t hash = kFnvOffsetBasis)
+{
+    return (*s == '\0') ? hash :
+           fnv1a(s + 1, (hash ^ static_cast<uint8_t>(*s)) * kFnvPrime);
+}
+
+/**
+ * Length of a string literal, rejecting pointers at compile time
+ *
+ * \param name String literal
+ * \return Number of characters without the terminating NUL
+ */
+template <size_t N>
+constexpr size_t name_length(const char (&name)[N])
+{
+    return (void)name, N - 1U;
+}
+
+/* ========================================================================== */
+/*                           Name IDs                                         */
+/* ========================================================================== */
+
+/**
+ * Name ID of one name, shared by every use of the name in the image
+ *
+ * The ID is cached for the lifetime of the image, so all names must be
+ * logged to the same stage. This holds for the usual layout of one stage
+ * per boot image.
+ */
+template <uint64_t Hash>
+class NameId
+{
+public:
+    /**
+     * Get the name ID, registering the name on first use
+     *
+     * \param name Name with this hash
+     * \return Name ID, BOOT_RECORD_NAME_ID_NONE if the name can't be registered
+     */
+    static uint32_t get(const char *name)
+    {
+        uint32_t name_id = __atomic_load_n(&id_, __ATOMIC_RELAXED);
+
+        if (name_id == BOOT_RECORD_NAME_ID_NONE)
+        {
+            /* Cores racing here get the same ID from the name table */
+            if (boot_record_register_name(name, &name_id) != BOOT_RECORD_SUCCESS)
+            {
+                return BOOT_RECORD_NAME_ID_NONE;
+            }
+            __atomic_store_n(&id_, name_id, __ATOMIC_RELAXED);
+        }
+
+        return name_id;
+    }
+
+private:
+    static uint32_t id_;
+};
+
+template <uint64_t Hash>
+uint32_t NameId<Hash>::id_ = BOOT_RECORD_NAME_ID_NONE;
+
+/* ========================================================================== */
+/*                           Scope Recorder                                   */
+/* ========================================================================== */
+
+/**
+ * Span covering the lifetime of the object
+ *
+ * Use through BOOT_RECORD_SCOPE, which supplies the hash and checks the name.
+ * The stage must be initialized with BOOT_RECORD_FLAG_NAME_IDS and without
+ * BOOT_RECORD_FLAG_COMPACT or BOOT_RECORD_FLAG_STREAM. If the span can't be
+ * opened, nothing is logged when the object is destroyed either.
+ */
+template <uint64_t Hash>
+class ScopedBootRecord
+{
+public:
+    explicit ScopedBootRecord(const char *name)
+        : open_(boot_record_begin_id(NameId<Hash>::get(name)) ==
+                BOOT_RECORD_SUCCESS)
+    {
+    }
+
+    ~ScopedBootRecord()
+    {
+        if (open_)
+        {
+            (void)boot_record_end();
+        }
+    }
+
+    ScopedBootRecord(const ScopedBootRecord &) = delete;
+    ScopedBootRecord &operator=(const ScopedBootRecord &) = delete;
+
+private:
+    bool open_;
+};
+
+} /* namespace bootrecord */
+
+#endif /* BOOT_RECORD_HPP */
@@ -0,0 +1,621 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_agg.c
+ * \brief Fleet-wide statistics of the time between boot record checkpoints
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_agg.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Ratio between the bounds of a bin, and its logarithm */
+#define SKETCH_GAMMA        ((1.0 + BOOT_RECORD_SKETCH_ALPHA) / \
+                             (1.0 - BOOT_RECORD_SKETCH_ALPHA))
+#define SKETCH_LOG_GAMMA    (log(SKETCH_GAMMA))
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Initialize an empty sketch
+ */
+void boot_record_sketch_init(boot_record_sketch_t *sketch)
+{
+    memset(sketch, 0, sizeof(*sketch));
+    sketch->lo = 1;
+    sketch->hi = 0;
+}
+
+/**
+ * Move the bin window of a sketch to start at a new bin index
+ *
+ * Used bins below the new window are collapsed into its lowest bin. Callers
+ * never move the window below a used bin's reach from the top.
+ */
+static void boot_record_sketch_move(boot_record_sketch_t *sketch,
+                                    int32_t offset)
+{
+    int64_t delta = (int64_t)offset - sketch->offset;
+    uint64_t collapsed = 0;
+    int64_t i;
+
+    if (delta > 0)
+    {
+        for (i = 0; i < delta && i < BOOT_RECORD_SKETCH_BINS; i++)
+        {
+            collapsed += sketch->bins[i];
+        }
+
+        if (delta < BOOT_RECORD_SKETCH_BINS)
+        {
+            memmove(sketch->bins, sketch->bins + delta,
+                    (size_t)(BOOT_RECORD_SKETCH_BINS - delta) *
+                    sizeof(sketch->bins[0]));
+            memset(sketch->bins + BOOT_RECORD_SKETCH_BINS - delta, 0,
+                   (size_t)delta * sizeof(sketch->bins[0]));
+        }
+        else
+        {
+            memset(sketch->bins, 0, sizeof(sketch->bins));
+        }
+
+        sketch->bins[0] += collapsed;
+        if (sketch->lo <= sketch->hi && sketch->lo < offset)
+        {
+            sketch->lo = offset;
+            if (sketch->hi < offset)
+            {
+                sketch->hi = offset;
+            }
+        }
+    }
+    else if (delta < 0)
+    {
+        memmove(sketch->bins - delta, sketch->bins,
+                (size_t)(BOOT_RECORD_SKETCH_BINS + delta) *
+                sizeof(sketch->bins[0]));
+        memset(sketch->bins, 0, (size_t)(-delta) * sizeof(sketch->bins[0]));
+    }
+
+    sketch->offset = offset;
+}
+
+/**
+ * Add a number of values to the bin of a bin index
+ */
+static void boot_record_sketch_add_bin(boot_record_sketch_t *sketch,
+                                       int32_t index, uint64_t n)
+{
+    if (sketch->lo > sketch->hi)
+    {
+        boot_record_sketch_move(sketch, index - BOOT_RECORD_SKETCH_BINS / 2);
+    }
+    else if (index >= sketch->offset + BOOT_RECORD_SKETCH_BINS)
+    {
+        /* Keep the largest values exact, collapse the smallest */
+        boot_record_sketch_move(sketch, index - BOOT_RECORD_SKETCH_BINS + 1);
+    }
+    else if (index < sketch->offset)
+    {
+        if (sketch->hi - index < BOOT_RECORD_SKETCH_BINS)
+        {
+            boot_record_sketch_move(sketch, index);
+        }
+        else
+        {
+            boot_record_sketch_move(sketch, sketch->hi - BOOT_RECORD_SKETCH_BINS + 1);
+            index = sketch->offset;
+        }
+    }
+
+    sketch->bins[index - sketch->offset] += n;
+
+    if (sketch->lo > sketch->hi)
+    {
+        sketch->lo = index;
+        sketch->hi = index;
+    }
+    else if (index < sketch->lo)
+    {
+        sketch->lo = index;
+    }
+    else if (index > sketch->hi)
+    {
+        sketch->hi = index;
+    }
+}
+
+/**
+ * Add a duration to a sketch
+ */
+void boot_record_sketch_add(boot_record_sketch_t *sketch, uint64_t value)
+{
+    if (sketch->count == 0 || value < sketch->min)
+    {
+        sketch->min = value;
+    }
+    if (value > sketch->max)
+    {
+        sketch->max = value;
+    }
+    sketch->count++;
+    sketch->sum += (double)value;
+
+    if (value == 0)
+    {
+        sketch->zero_count++;
+        return;
+    }
+
+    boot_record_sketch_add_bin(sketch,
+                               (int32_t)ceil(log((double)value) / SKETCH_LOG_GAMMA),
+                               1U);
+}
+
+/**
+ * Add all values of one sketch to another
+ */
+void boot_record_sketch_merge(boot_record_sketch_t *dst,
+                              const boot_record_sketch_t *src)
+{
+    int32_t index;
+
+    if (src->count == 0)
+    {
+        return;
+    }
+
+    if (dst->count == 0 || src->min < dst->min)
+    {
+        dst->min = src->min;
+    }
+    if (src->max > dst->max)
+    {
+        dst->max = src->max;
+    }
+    dst->count += src->count;
+    dst->zero_count += src->zero_count;
+    dst->sum += src->sum;
+
+    /* Add the highest bins first, so the window moves at most once */
+    for (index = src->hi; index >= src->lo; index--)
+    {
+        if (src->bins[index - src->offset])
+        {
+            boot_record_sketch_add_bin(dst, index, src->bins[index - src->offset]);
+        }
+    }
+}
+
+/**
+ * Estimate a quantile of the values added to a sketch
+ */
+double boot_record_sketch_quantile(const boot_record_sketch_t *sketch, double q)
+{
+    double rank;
+    double value;
+    uint64_t seen;
+    int32_t index;
+
+    if (sketch->count == 0)
+    {
+        return 0.0;
+    }
+
+    rank = (q <= 0.0) ? 0.0 : (q >= 1.0) ? (double)(sketch->count - 1U) :
+           q * (double)(sketch->count - 1U);
+
+    seen = sketch->zero_count;
+    if ((double)seen > rank)
+    {
+        return 0.0;
+    }
+
+    for (index = sketch->lo; index <= sketch->hi; index++)
+    {
+        seen += sketch->bins[index - sketch->offset];
+        if ((double)seen > rank)
+        {
+            break;
+        }
+    }
+
+    /* Midpoint of the bin in relative terms, within its true range */
+    value = 2.0 * pow(SKETCH_GAMMA, index) / (SKETCH_GAMMA + 1.0);
+    if (value < (double)sketch->min)
+    {
+        value = (double)sketch->min;
+    }
+    if (value > (double)sketch->max)
+    {
+        value = (double)sketch->max;
+    }
+
+    return value;
+}
+
+/**
+ * Number of values in the bin of a bin index
+ */
+static uint64_t boot_record_sketch_bin(const boot_record_sketch_t *sketch,
+                                       int32_t index)
+{
+    if (index < sketch->lo || index > sketch->hi)
+    {
+        return 0;
+    }
+
+    return sketch->bins[index - sketch->offset];
+}
+
+/**
+ * Test whether the values of one sketch tend to be larger than another's
+ */
+double boot_record_sketch_mann_whitney(const boot_record_sketch_t *a,
+                                       const boot_record_sketch_t *b,
+                                       double *z)
+{
+    double n1 = (double)a->count;
+    double n2 = (double)b->count;
+    double n = n1 + n2;
+    double below_b = (double)b->zero_count;
+    double ties;
+    double u;
+    double t;
+    double var;
+    double diff;
+    int32_t lo;
+    int32_t hi;
+    int32_t index;
+
+    *z = 0.0;
+    if (a->count == 0 || b->count == 0)
+    {
+        return 1.0;
+    }
+
+    /* U counts the pairs with the value of a above the value of b, a tie
+     * counting half; values sharing a bin are ties */
+    t = (double)(a->zero_count + b->zero_count);
+    u = (double)a->zero_count * 0.5 * (double)b->zero_count;
+    ties = t * t * t - t;
+
+    lo = (a->lo <= a->hi) ? a->lo : b->lo;
+    hi = (a->lo <= a->hi) ? a->hi : b->hi;
+    if (b->lo <= b->hi)
+    {
+        lo = (b->lo < lo) ? b->lo : lo;
+        hi = (b->hi > hi) ? b->hi : hi;
+    }
+
+    for (index = lo; index <= hi; index++)
+    {
+        n1 = (double)boot_record_sketch_bin(a, index);
+        n2 = (double)boot_record_sketch_bin(b, index);
+        u += n1 * (below_b + 0.5 * n2);
+        below_b += n2;
+        t = n1 + n2;
+        ties += t * t * t - t;
+    }
+
+    /* Normal approximation with tie and continuity corrections */
+    n1 = (double)a->count;
+    n2 = (double)b->count;
+    var = n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0)));
+    diff = fabs(u - n1 * n2 / 2.0) - 0.5;
+    if (var <= 0.0 || diff <= 0.0)
+    {
+        return 1.0;
+    }
+
+    *z = ((u > n1 * n2 / 2.0) ? diff : -diff) / sqrt(var);
+
+    return erfc(fabs(*z) / sqrt(2.0));
+}
+
+/**
+ * Initialize an empty aggregate
+ */
+boot_record_status_t boot_record_agg_init(boot_record_agg_t *agg,
+                                         uint32_t max_pairs)
+{
+    if (!agg || max_pairs > UINT32_MAX / 2U)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    memset(agg, 0, sizeof(*agg));
+    agg->max_pairs = max_pairs ? max_pairs : BOOT_RECORD_AGG_DEFAULT_PAIRS;
+    agg->slot_count = 2U * agg->max_pairs;
+    agg->slots = calloc(agg->slot_count, sizeof(*agg->slots));
+
+    return agg->slots ? BOOT_RECORD_SUCCESS : BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+}
+
+/**
+ * Free the memory of an aggregate
+ */
+void boot_record_agg_free(boot_record_agg_t *agg)
+{
+    uint32_t i;
+
+    if (!agg || !agg->slots)
+    {
+        return;
+    }
+
+    for (i = 0; i < agg->slot_count; i++)
+    {
+        free(agg->slots[i]);
+    }
+    free(agg->slots);
+    memset(agg, 0, sizeof(*agg));
+}
+
+/**
+ * Hash slot of the pair with the key of a template pair
+ *
+ * \param key Pair whose stage, kinds and names are the key, zero padded
+ * \return Slot holding the pair, or the free slot to insert it into
+ */
+static uint32_t boot_record_agg_slot(const boot_record_agg_t *agg,
+                                     const boot_record_pair_t *key)
+{
+    const uint8_t *bytes = (const uint8_t *)key;
+    size_t key_size = offsetof(boot_record_pair_t, sketch);
+    uint32_t hash = 2166136261U;
+    uint32_t i;
+    size_t n;
+
+    for (n = 0; n < key_size; n++)
+    {
+        hash = (hash ^ bytes[n]) * 16777619U;
+    }
+
+    for (i = hash % agg->slot_count; agg->slots[i];
+         i = (i + 1U) % agg->slot_count)
+    {
+        if (memcmp(agg->slots[i], key, key_size) == 0)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/**
+ * Find the pair with the key of a template pair, adding it if new
+ *
+ * \param key Pair whose stage, kinds and names are the key, zero padded
+ * \return Pair, NULL if it is new and max_pairs is reached
+ */
+static boot_record_pair_t *boot_record_agg_find(boot_record_agg_t *agg,
+                                                const boot_record_pair_t *key)
+{
+    uint32_t i = boot_record_agg_slot(agg, key);
+    boot_record_pair_t *pair;
+
+    if (agg->slots[i])
+    {
+        return agg->slots[i];
+    }
+
+    if (agg->pair_count >= agg->max_pairs)
+    {
+        return NULL;
+    }
+
+    pair = malloc(sizeof(*pair));
+    if (!pair)
+    {
+        return NULL;
+    }
+
+    memcpy(pair, key, offsetof(boot_record_pair_t, sketch));
+    boot_record_sketch_init(&pair->sketch);
+    agg->slots[i] = pair;
+    agg->pair_count++;
+
+    return pair;
+}
+
+/**
+ * Look up the pair with the key of a template pair
+ */
+const boot_record_pair_t *boot_record_agg_lookup(const boot_record_agg_t *agg,
+                                                 const boot_record_pair_t *key)
+{
+    return agg->slots[boot_record_agg_slot(agg, key)];
+}
+
+/**
+ * Add a sketch to the pair with the key of a template pair
+ */
+void boot_record_agg_add_sketch(boot_record_agg_t *agg,
+                                const boot_record_pair_t *key,
+                                const boot_record_sketch_t *sketch)
+{
+    boot_record_pair_t *pair = boot_record_agg_find(agg, key);
+
+    if (pair)
+    {
+        boot_record_sketch_merge(&pair->sketch, sketch);
+    }
+    else
+    {
+        agg->dropped += sketch->count;
+    }
+}
+
+/**
+ * Copy the name of a record into a key, zero padded; empty for a span end
+ * whose begin record was overwritten
+ */
+static void boot_record_agg_name(char *dst, const boot_record_event_t *event)
+{
+    memset(dst, 0, BOOT_RECORD_NAME_LEN);
+    if (event->name)
+    {
+        strncpy(dst, event->name, BOOT_RECORD_NAME_LEN - 1U);
+    }
+    else if (event->name_id != BOOT_RECORD_NAME_ID_NONE)
+    {
+        snprintf(dst, BOOT_RECORD_NAME_LEN, "#%" PRIu32, event->name_id);
+    }
+}
+
+/**
+ * Add the durations between the records of a stage to an aggregate
+ */
+void boot_record_agg_add_stage(boot_record_agg_t *agg,
+                               const boot_stage_record_t *stage)
+{
+    boot_record_record_iter_t iter;
+    boot_record_event_t event;
+    boot_record_tconv_t to_ns;
+    boot_record_pair_t key;
+    boot_record_pair_t *pair;
+    uint64_t prev_ns = 0;
+    uint64_t ns;
+    uint32_t prev_cpu = BOOT_RECORD_MAX_CPUS;
+
+    memset(&key, 0, offsetof(boot_record_pair_t, sketch));
+    key.stage_id = stage->record_id;
+
+    if (boot_record_tconv_init(&to_ns, stage, BOOT_RECORD_UNIT_NS) != BOOT_RECORD_SUCCESS)
+    {
+        agg->rejected++;
+        return;
+    }
+
+    boot_record_record_iter_init(&iter, stage);
+    while (boot_record_record_iter_next_event(&iter, &event))
+    {
+        ns = boot_record_tconv_apply(&to_ns, event.time);
+
+        /* Pairs are consecutive records of one CPU, a clock going back
+         * gives no duration */
+        if (event.cpu_id == prev_cpu && ns >= prev_ns)
+        {
+            key.to_kind = (uint8_t)event.kind;
+            boot_record_agg_name(key.to, &event);
+
+            pair = boot_record_agg_find(agg, &key);
+            if (pair)
+            {
+                boot_record_sketch_add(&pair->sketch, ns - prev_ns);
+            }
+            else
+            {
+                agg->dropped++;
+            }
+        }
+
+        key.from_kind = (uint8_t)event.kind;
+        boot_record_agg_name(key.from, &event);
+        prev_cpu = event.cpu_id;
+        prev_ns = ns;
+    }
+
+    agg->stages++;
+}
+
+/**
+ * Add every stage of a mapped dump to an aggregate
+ */
+boot_record_status_t boot_record_agg_add_dump(boot_record_agg_t *agg,
+                                             const boot_record_dump_t *dump)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t iter;
+
+    boot_record_stage_iter_init(&iter, dump);
+    while ((stage = boot_record_stage_iter_next(&iter)) != NULL)
+    {
+        boot_record_agg_add_stage(agg, stage);
+    }
+
+    return iter.status;
+}
+
+/**
+ * Add all pairs of one aggregate to another
+ */
+void boot_record_agg_merge(boot_record_agg_t *dst, const boot_record_agg_t *src)
+{
+    uint32_t i;
+
+    for (i = 0; i < src->slot_count; i++)
+    {
+        if (src->slots[i])
+        {
+            boot_record_agg_add_sketch(dst, src->slots[i], &src->slots[i]->sketch);
+        }
+    }
+
+    dst->stages += src->stages;
+    dst->dropped += src->dropped;
+    dst->rejected += src->rejected;
+}
+
+/**
+ * Call a function for every pair of an aggregate, in no particular order
+ */
+void boot_record_agg_foreach(const boot_record_agg_t *agg,
+                             boot_record_pair_fn fn, void *arg)
+{
+    uint32_t i;
+
+    for (i = 0; i < agg->slot_count; i++)
+    {
+        if (agg->slots[i])
+        {
+            fn(agg->slots[i], arg);
+        }
+    }
+}
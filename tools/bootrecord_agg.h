@@ -0,0 +1,294 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_agg.h
+ * \brief Fleet-wide statistics of the time between boot record checkpoints
+ *
+ * An aggregate keeps one quantile sketch per (stage ID, profile name, next
+ * profile name) pair, fed with the time from each record to the next one
+ * logged on the same CPU. The sketches are DDSketches: every quantile is
+ * within BOOT_RECORD_SKETCH_ALPHA relative error, and each sketch has a
+ * fixed number of bins. With the number of pairs also capped, memory use
+ * is bounded however many boots are added. Aggregates built from separate
+ * sets of dumps, for example on several threads, merge exactly as long as
+ * the pair cap is not reached. Beyond it, which pairs are kept and how many
+ * values are dropped depend on the order the dumps were added in.
+ */
+
+#ifndef BOOT_RECORD_AGG_H
+#define BOOT_RECORD_AGG_H
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stdint.h>
+
+#include "bootrecord_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Relative accuracy of the quantiles of a sketch
+ */
+#define BOOT_RECORD_SKETCH_ALPHA            (0.01)
+
+/**
+ * Number of bins of a sketch. With 1% accuracy they span a range of about
+ * 1:10^8, e.g. 10 ns to 1 s; values below the range share the lowest bin
+ */
+#ifndef BOOT_RECORD_SKETCH_BINS
+#define BOOT_RECORD_SKETCH_BINS             (1024)
+#endif
+
+/**
+ * Default maximum number of pairs in an aggregate
+ */
+#define BOOT_RECORD_AGG_DEFAULT_PAIRS       (4096U)
+
+/**
+ * DDSketch of non-negative durations in nanoseconds
+ */
+typedef struct
+{
+    /* Number of values added */
+    uint64_t count;
+    /* Number of values too small for any bin, i.e. 0 */
+    uint64_t zero_count;
+    /* Smallest and largest value added */
+    uint64_t min;
+    uint64_t max;
+    /* Sum of the values added */
+    double sum;
+    /* Bin index of bins[0] */
+    int32_t offset;
+    /* Lowest and highest used bin index, lo > hi while no bin is used */
+    int32_t lo;
+    int32_t hi;
+    /* Number of values per bin */
+    uint64_t bins[BOOT_RECORD_SKETCH_BINS];
+} boot_record_sketch_t;
+
+/**
+ * Durations between two consecutive profile points of a stage
+ */
+typedef struct
+{
+    /* Stage ID of the records */
+    uint32_t stage_id;
+    /* Record kinds (BOOT_RECORD_KIND_*) of the two records */
+    uint8_t from_kind;
+    uint8_t to_kind;
+    uint16_t reserved;
+    /* Names of the two records */
+    char from[BOOT_RECORD_NAME_LEN];
+    char to[BOOT_RECORD_NAME_LEN];
+    /* Durations from the first record to the second, in nanoseconds */
+    boot_record_sketch_t sketch;
+} boot_record_pair_t;
+
+/**
+ * Aggregate of any number of boot stages
+ */
+typedef struct
+{
+    /* Open addressing hash table of pairs, twice max_pairs slots */
+    boot_record_pair_t **slots;
+    uint32_t slot_count;
+    /* Maximum and current number of pairs */
+    uint32_t max_pairs;
+    uint32_t pair_count;
+    /* Number of stages added */
+    uint64_t stages;
+    /* Number of durations dropped because max_pairs was reached */
+    uint64_t dropped;
+    /* Number of stages skipped because their timestamps can't be
+     * converted to nanoseconds */
+    uint64_t rejected;
+} boot_record_agg_t;
+
+/**
+ * Callback receiving one pair of an aggregate
+ */
+typedef void (*boot_record_pair_fn)(const boot_record_pair_t *pair, void *arg);
+
+/* ========================================================================== */
+/*                          Function Declarations                             */
+/* ========================================================================== */
+
+/**
+ * Initialize an empty sketch
+ *
+ * \param sketch Sketch to initialize
+ */
+void boot_record_sketch_init(boot_record_sketch_t *sketch);
+
+/**
+ * Add a duration to a sketch
+ *
+ * \param sketch Sketch to add to
+ * \param value Duration in nanoseconds
+ */
+void boot_record_sketch_add(boot_record_sketch_t *sketch, uint64_t value);
+
+/**
+ * Add all values of one sketch to another
+ *
+ * \param dst Sketch to add to
+ * \param src Sketch to add
+ */
+void boot_record_sketch_merge(boot_record_sketch_t *dst,
+                              const boot_record_sketch_t *src);
+
+/**
+ * Estimate a quantile of the values added to a sketch
+ *
+ * \param sketch Sketch to read
+ * \param q Quantile from 0 to 1, e.g. 0.99
+ * \return Estimated value in nanoseconds, 0 for an empty sketch
+ */
+double boot_record_sketch_quantile(const boot_record_sketch_t *sketch, double q);
+
+/**
+ * Test whether the values of one sketch tend to be larger than another's
+ *
+ * Computes the Mann-Whitney U statistic from the bins of the two sketches,
+ * values sharing a bin counting as ties, so differences below the sketch
+ * accuracy are not detected. The p-value uses the normal approximation
+ * with tie correction, which needs about 20 values per sketch.
+ *
+ * \param a First sketch
+ * \param b Second sketch
+ * \param z Pointer to receive the z-score, positive if the values of a tend
+ *        to be larger
+ * \return Two-sided p-value, 1 if a sketch is empty
+ */
+double boot_record_sketch_mann_whitney(const boot_record_sketch_t *a,
+                                       const boot_record_sketch_t *b,
+                                       double *z);
+
+/**
+ * Initialize an empty aggregate
+ *
+ * \param agg Aggregate to initialize
+ * \param max_pairs Maximum number of pairs, 0 for the default
+ * \return BOOT_RECORD_SUCCESS on success, error code on failure
+ */
+boot_record_status_t boot_record_agg_init(boot_record_agg_t *agg,
+                                         uint32_t max_pairs);
+
+/**
+ * Free the memory of an aggregate
+ *
+ * \param agg Aggregate initialized by boot_record_agg_init
+ */
+void boot_record_agg_free(boot_record_agg_t *agg);
+
+/**
+ * Add the durations between the records of a stage to an aggregate
+ *
+ * A stage whose tick rate has no converter to nanoseconds is skipped and
+ * counted in agg->rejected.
+ *
+ * \param agg Aggregate to add to
+ * \param stage Stage validated by boot_record_validate
+ */
+void boot_record_agg_add_stage(boot_record_agg_t *agg,
+                               const boot_stage_record_t *stage);
+
+/**
+ * Add every stage of a mapped dump to an aggregate
+ *
+ * \param agg Aggregate to add to
+ * \param dump Mapped dump
+ * \return BOOT_RECORD_SUCCESS on success, error code if a stage is invalid;
+ *         the stages before it are added
+ */
+boot_record_status_t boot_record_agg_add_dump(boot_record_agg_t *agg,
+                                             const boot_record_dump_t *dump);
+
+/**
+ * Look up the pair with the key of a template pair
+ *
+ * \param agg Aggregate to search
+ * \param key Pair whose stage, kinds and names are the key, zero padded;
+ *        its sketch is not read
+ * \return Pair, NULL if the aggregate has no such pair
+ */
+const boot_record_pair_t *boot_record_agg_lookup(const boot_record_agg_t *agg,
+                                                 const boot_record_pair_t *key);
+
+/**
+ * Add a sketch to the pair with the key of a template pair
+ *
+ * \param agg Aggregate to add to
+ * \param key Pair whose stage, kinds and names are the key, zero padded;
+ *        its sketch is not read
+ * \param sketch Sketch to add, counted as dropped if max_pairs is reached
+ */
+void boot_record_agg_add_sketch(boot_record_agg_t *agg,
+                                const boot_record_pair_t *key,
+                                const boot_record_sketch_t *sketch);
+
+/**
+ * Add all pairs of one aggregate to another
+ *
+ * The result equals one aggregate fed with the dumps of both, unless
+ * max_pairs is reached; then the pairs kept depend on the merge order.
+ *
+ * \param dst Aggregate to add to
+ * \param src Aggregate to add
+ */
+void boot_record_agg_merge(boot_record_agg_t *dst, const boot_record_agg_t *src);
+
+/**
+ * Call a function for every pair of an aggregate, in no particular order
+ *
+ * \param agg Aggregate to read
+ * \param fn Function to call
+ * \param arg Opaque argument passed to fn
+ */
+void boot_record_agg_foreach(const boot_record_agg_t *agg,
+                             boot_record_pair_fn fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RECORD_AGG_H */
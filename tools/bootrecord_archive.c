@@ -0,0 +1,888 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_archive.c
+ * \brief Append-only columnar archive of the records of many boots
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_archive.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Column encodings */
+#define ENCODING_DELTA                      (0U)
+#define ENCODING_U32                        (1U)
+#define ENCODING_U8                         (2U)
+
+/* Longest LEB128 encoding of a 64 bit value */
+#define VARINT_MAX_SIZE                     (10U)
+
+/* Round a chunk size up to the chunk alignment */
+#define CHUNK_ALIGN(size)                   (((size) + 7U) & ~7U)
+
+static const uint8_t column_encoding[BOOT_RECORD_ARCHIVE_COLUMNS] =
+{
+    ENCODING_DELTA,     /* boot */
+    ENCODING_DELTA,     /* wall */
+    ENCODING_DELTA,     /* stage */
+    ENCODING_U32,       /* name */
+    ENCODING_U8,        /* kind */
+    ENCODING_DELTA,     /* time */
+};
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Check the chunks of a mapped archive and index its names and blocks
+ */
+static boot_record_status_t boot_record_archive_index(boot_record_archive_t *archive)
+{
+    const uint8_t *data = archive->dump.data;
+    const boot_record_archive_header_t *header = (const void *)data;
+    const boot_record_archive_chunk_t *chunk;
+    const boot_record_archive_names_t *names;
+    const boot_record_archive_block_t *block;
+    const char *name;
+    void *grown;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t col;
+    uint32_t i;
+
+    if (archive->dump.size < sizeof(*header) ||
+        header->chunk.magic != BOOT_RECORD_ARCHIVE_MAGIC ||
+        header->chunk.size != sizeof(*header) ||
+        header->version != BOOT_RECORD_ARCHIVE_VERSION ||
+        header->byte_order != BOOT_RECORD_BYTE_ORDER)
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    offset = sizeof(*header);
+    archive->valid_size = offset;
+
+    /* A chunk running past the end was cut short and ends the archive */
+    while (archive->dump.size - offset >= sizeof(*chunk))
+    {
+        chunk = (const void *)(data + offset);
+        size = chunk->size;
+        if (size < sizeof(*chunk) || size != CHUNK_ALIGN(size) ||
+            size > archive->dump.size - offset)
+        {
+            break;
+        }
+
+        if (chunk->magic == BOOT_RECORD_ARCHIVE_NAMES_MAGIC)
+        {
+            names = (const void *)chunk;
+            if (size < sizeof(*names) || names->first != archive->name_count ||
+                names->count > (size - sizeof(*names)) / BOOT_RECORD_NAME_LEN)
+            {
+                return BOOT_RECORD_ERR_FORMAT;
+            }
+
+            grown = realloc(archive->names, (archive->name_count + names->count) *
+                            sizeof(*archive->names));
+            if (!grown && names->count)
+            {
+                return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+            }
+            archive->names = grown;
+
+            for (i = 0; i < names->count; i++)
+            {
+                name = (const char *)(names + 1) + i * BOOT_RECORD_NAME_LEN;
+                if (name[BOOT_RECORD_NAME_LEN - 1U] != '\0')
+                {
+                    return BOOT_RECORD_ERR_FORMAT;
+                }
+                archive->names[archive->name_count++] = name;
+            }
+        }
+        else if (chunk->magic == BOOT_RECORD_ARCHIVE_BLOCK_MAGIC)
+        {
+            block = (const void *)chunk;
+            if (size < sizeof(*block) ||
+                block->row_count > BOOT_RECORD_ARCHIVE_BLOCK_ROWS)
+            {
+                return BOOT_RECORD_ERR_FORMAT;
+            }
+
+            for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+            {
+                if (block->column_offset[col] < sizeof(*block) ||
+                    block->column_offset[col] > size ||
+                    block->column_size[col] > size - block->column_offset[col] ||
+                    (column_encoding[col] == ENCODING_U32 &&
+                     block->column_size[col] != block->row_count * 4U) ||
+                    (column_encoding[col] == ENCODING_U8 &&
+                     block->column_size[col] != block->row_count))
+                {
+                    return BOOT_RECORD_ERR_FORMAT;
+                }
+            }
+
+            grown = realloc(archive->blocks, (archive->block_count + 1U) *
+                            sizeof(*archive->blocks));
+            if (!grown)
+            {
+                return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+            }
+            archive->blocks = grown;
+            archive->blocks[archive->block_count++] = block;
+
+            if (block->row_count &&
+                block->stats[BOOT_RECORD_ARCHIVE_COL_BOOT].max >= archive->boot_count)
+            {
+                archive->boot_count = block->stats[BOOT_RECORD_ARCHIVE_COL_BOOT].max + 1U;
+            }
+        }
+        else
+        {
+            break;
+        }
+
+        offset += size;
+        archive->valid_size = offset;
+    }
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Open an archive for reading
+ */
+boot_record_status_t boot_record_archive_open(boot_record_archive_t *archive,
+                                              const char *path)
+{
+    boot_record_status_t status;
+
+    memset(archive, 0, sizeof(*archive));
+
+    status = boot_record_dump_open(&archive->dump, path, 0, 0);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    status = boot_record_archive_index(archive);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        boot_record_archive_close(archive);
+    }
+
+    return status;
+}
+
+/**
+ * Close an archive opened for reading
+ */
+void boot_record_archive_close(boot_record_archive_t *archive)
+{
+    boot_record_dump_close(&archive->dump);
+    free(archive->names);
+    free(archive->blocks);
+    memset(archive, 0, sizeof(*archive));
+}
+
+/**
+ * Look up the dictionary index of a name
+ */
+uint32_t boot_record_archive_find_name(const boot_record_archive_t *archive,
+                                       const char *name)
+{
+    uint32_t i;
+
+    for (i = 0; i < archive->name_count; i++)
+    {
+        if (strncmp(archive->names[i], name, BOOT_RECORD_NAME_LEN) == 0)
+        {
+            return i;
+        }
+    }
+
+    return BOOT_RECORD_NAME_ID_NONE;
+}
+
+/**
+ * Initialize a query passing every column of every row
+ */
+void boot_record_archive_query_init(boot_record_archive_query_t *query)
+{
+    uint32_t col;
+
+    query->columns = BOOT_RECORD_ARCHIVE_COLUMN(BOOT_RECORD_ARCHIVE_COLUMNS) - 1U;
+    for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+    {
+        query->filter[col].min = 0;
+        query->filter[col].max = UINT64_MAX;
+    }
+}
+
+/**
+ * Decode a column of a block
+ */
+static boot_record_status_t boot_record_archive_decode(const boot_record_archive_block_t *block,
+                                                       uint32_t col, uint64_t *values)
+{
+    const uint8_t *src = (const uint8_t *)block + block->column_offset[col];
+    const uint8_t *end = src + block->column_size[col];
+    uint64_t value = 0;
+    uint64_t delta;
+    uint32_t shift;
+    uint32_t word;
+    uint32_t i;
+
+    switch (column_encoding[col])
+    {
+        case ENCODING_U32:
+            for (i = 0; i < block->row_count; i++)
+            {
+                memcpy(&word, src + 4U * i, sizeof(word));
+                values[i] = word;
+            }
+            break;
+
+        case ENCODING_U8:
+            for (i = 0; i < block->row_count; i++)
+            {
+                values[i] = src[i];
+            }
+            break;
+
+        default:
+            /* Zigzag LEB128 deltas from the previous row, from 0 in the
+             * first row */
+            for (i = 0; i < block->row_count; i++)
+            {
+                delta = 0;
+                shift = 0;
+                do
+                {
+                    if (src == end || shift >= 64U)
+                    {
+                        return BOOT_RECORD_ERR_FORMAT;
+                    }
+                    delta |= (uint64_t)(*src & 0x7FU) << shift;
+                    shift += 7U;
+                } while (*src++ & 0x80U);
+
+                value += (delta >> 1) ^ (0U - (delta & 1U));
+                values[i] = value;
+            }
+
+            if (src != end)
+            {
+                return BOOT_RECORD_ERR_FORMAT;
+            }
+            break;
+    }
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Call a function for every row matching a query, in archive order
+ */
+boot_record_status_t boot_record_archive_scan(const boot_record_archive_t *archive,
+                                              const boot_record_archive_query_t *query,
+                                              boot_record_archive_row_fn fn,
+                                              void *arg,
+                                              boot_record_archive_scan_t *scan)
+{
+    boot_record_status_t status = BOOT_RECORD_SUCCESS;
+    const boot_record_archive_block_t *block;
+    const boot_record_archive_range_t *filter = query->filter;
+    boot_record_archive_scan_t counters = { 0 };
+    uint64_t *columns[BOOT_RECORD_ARCHIVE_COLUMNS];
+    uint64_t row[BOOT_RECORD_ARCHIVE_COLUMNS];
+    uint32_t filtered = 0;
+    uint32_t decoded;
+    uint32_t matches;
+    uint8_t *match;
+    uint32_t b;
+    uint32_t col;
+    uint32_t i;
+
+    for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+    {
+        if (filter[col].min > 0 || filter[col].max < UINT64_MAX)
+        {
+            filtered |= BOOT_RECORD_ARCHIVE_COLUMN(col);
+        }
+    }
+
+    columns[0] = malloc(BOOT_RECORD_ARCHIVE_COLUMNS * BOOT_RECORD_ARCHIVE_BLOCK_ROWS *
+                        sizeof(uint64_t));
+    match = malloc(BOOT_RECORD_ARCHIVE_BLOCK_ROWS);
+    if (!columns[0] || !match)
+    {
+        free(columns[0]);
+        free(match);
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+    for (col = 1; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+    {
+        columns[col] = columns[col - 1U] + BOOT_RECORD_ARCHIVE_BLOCK_ROWS;
+    }
+
+    for (b = 0; b < archive->block_count && status == BOOT_RECORD_SUCCESS; b++)
+    {
+        block = archive->blocks[b];
+
+        for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+        {
+            if (filter[col].min > block->stats[col].max ||
+                filter[col].max < block->stats[col].min)
+            {
+                break;
+            }
+        }
+        if (col < BOOT_RECORD_ARCHIVE_COLUMNS || block->row_count == 0)
+        {
+            counters.blocks_skipped++;
+            continue;
+        }
+        counters.blocks_read++;
+
+        /* Filtered columns first, the others only if a row matches */
+        memset(match, 1, block->row_count);
+        matches = block->row_count;
+        decoded = 0;
+        for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS && matches; col++)
+        {
+            if (!(filtered & BOOT_RECORD_ARCHIVE_COLUMN(col)))
+            {
+                continue;
+            }
+
+            status = boot_record_archive_decode(block, col, columns[col]);
+            if (status != BOOT_RECORD_SUCCESS)
+            {
+                break;
+            }
+            decoded |= BOOT_RECORD_ARCHIVE_COLUMN(col);
+
+            matches = 0;
+            for (i = 0; i < block->row_count; i++)
+            {
+                match[i] &= (columns[col][i] >= filter[col].min) &
+                            (columns[col][i] <= filter[col].max);
+                matches += match[i];
+            }
+        }
+
+        for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS && matches &&
+             status == BOOT_RECORD_SUCCESS; col++)
+        {
+            if ((query->columns & BOOT_RECORD_ARCHIVE_COLUMN(col)) &&
+                !(decoded & BOOT_RECORD_ARCHIVE_COLUMN(col)))
+            {
+                status = boot_record_archive_decode(block, col, columns[col]);
+            }
+        }
+
+        for (i = 0; i < block->row_count && matches &&
+             status == BOOT_RECORD_SUCCESS; i++)
+        {
+            if (!match[i])
+            {
+                continue;
+            }
+
+            for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+            {
+                row[col] = (query->columns & BOOT_RECORD_ARCHIVE_COLUMN(col)) ?
+                           columns[col][i] : 0U;
+            }
+            fn(row, arg);
+            counters.rows++;
+        }
+    }
+
+    free(columns[0]);
+    free(match);
+
+    if (scan)
+    {
+        *scan = counters;
+    }
+
+    return status;
+}
+
+/**
+ * Write a whole buffer to a file descriptor
+ */
+static boot_record_status_t boot_record_archive_write(int fd, const void *buf,
+                                                      size_t size)
+{
+    const uint8_t *src = buf;
+    ssize_t written;
+
+    while (size)
+    {
+        written = write(fd, src, size);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return BOOT_RECORD_ERR_INVALID_PARAMS;
+        }
+        src += written;
+        size -= (size_t)written;
+    }
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Hash slot of a zero padded name in the writer's dictionary
+ *
+ * \return Slot holding the name, or the free slot to insert it into
+ */
+static uint32_t boot_record_archive_slot(const boot_record_archive_writer_t *writer,
+                                         const char *key)
+{
+    uint32_t hash = 2166136261U;
+    uint32_t slot;
+    uint32_t i;
+
+    for (i = 0; i < BOOT_RECORD_NAME_LEN; i++)
+    {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619U;
+    }
+
+    for (slot = hash & (writer->slot_count - 1U); writer->name_slots[slot];
+         slot = (slot + 1U) & (writer->slot_count - 1U))
+    {
+        if (memcmp(writer->names + (writer->name_slots[slot] - 1U) * BOOT_RECORD_NAME_LEN,
+                   key, BOOT_RECORD_NAME_LEN) == 0)
+        {
+            break;
+        }
+    }
+
+    return slot;
+}
+
+/**
+ * Get the dictionary index of a name, adding it if new
+ *
+ * \return Dictionary index, BOOT_RECORD_NAME_ID_NONE if out of memory
+ */
+static uint32_t boot_record_archive_intern(boot_record_archive_writer_t *writer,
+                                           const char *name)
+{
+    char key[BOOT_RECORD_NAME_LEN];
+    uint32_t *slots;
+    uint32_t slot_count;
+    uint32_t slot;
+    char *names;
+    uint32_t i;
+
+    memset(key, 0, sizeof(key));
+    strncpy(key, name, BOOT_RECORD_NAME_LEN - 1U);
+
+    /* Keep the table at most half full */
+    if (2U * (writer->name_count + 1U) > writer->slot_count)
+    {
+        slot_count = writer->slot_count ? 2U * writer->slot_count : 1024U;
+        slots = calloc(slot_count, sizeof(*slots));
+        if (!slots)
+        {
+            return BOOT_RECORD_NAME_ID_NONE;
+        }
+
+        free(writer->name_slots);
+        writer->name_slots = slots;
+        writer->slot_count = slot_count;
+        for (i = 0; i < writer->name_count; i++)
+        {
+            slot = boot_record_archive_slot(writer,
+                                            writer->names + i * BOOT_RECORD_NAME_LEN);
+            writer->name_slots[slot] = i + 1U;
+        }
+    }
+
+    slot = boot_record_archive_slot(writer, key);
+    if (writer->name_slots[slot])
+    {
+        return writer->name_slots[slot] - 1U;
+    }
+
+    if (writer->name_count == writer->name_capacity)
+    {
+        writer->name_capacity = writer->name_capacity ? 2U * writer->name_capacity : 256U;
+        names = realloc(writer->names, (size_t)writer->name_capacity * BOOT_RECORD_NAME_LEN);
+        if (!names)
+        {
+            return BOOT_RECORD_NAME_ID_NONE;
+        }
+        writer->names = names;
+    }
+
+    memcpy(writer->names + (size_t)writer->name_count * BOOT_RECORD_NAME_LEN, key,
+           BOOT_RECORD_NAME_LEN);
+    writer->name_slots[slot] = ++writer->name_count;
+
+    return writer->name_count - 1U;
+}
+
+/**
+ * Write the names added since the last block and the buffered rows
+ */
+static boot_record_status_t boot_record_archive_flush(boot_record_archive_writer_t *writer)
+{
+    boot_record_archive_block_t *block = (void *)writer->buffer;
+    boot_record_archive_names_t names;
+    boot_record_status_t status;
+    const uint64_t *values;
+    uint64_t prev;
+    uint64_t delta;
+    uint32_t offset;
+    uint32_t word;
+    uint32_t col;
+    uint32_t i;
+
+    if (writer->row_count == 0)
+    {
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    if (writer->names_written < writer->name_count)
+    {
+        names.chunk.magic = BOOT_RECORD_ARCHIVE_NAMES_MAGIC;
+        names.count = writer->name_count - writer->names_written;
+        names.chunk.size = sizeof(names) + names.count * BOOT_RECORD_NAME_LEN;
+        names.first = writer->names_written;
+
+        status = boot_record_archive_write(writer->fd, &names, sizeof(names));
+        if (status == BOOT_RECORD_SUCCESS)
+        {
+            status = boot_record_archive_write(writer->fd,
+                                               writer->names + (size_t)names.first * BOOT_RECORD_NAME_LEN,
+                                               (size_t)names.count * BOOT_RECORD_NAME_LEN);
+        }
+        if (status != BOOT_RECORD_SUCCESS)
+        {
+            return status;
+        }
+        writer->names_written = writer->name_count;
+    }
+
+    memset(block, 0, sizeof(*block));
+    block->chunk.magic = BOOT_RECORD_ARCHIVE_BLOCK_MAGIC;
+    block->row_count = writer->row_count;
+    offset = sizeof(*block);
+
+    for (col = 0; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+    {
+        values = writer->rows[col];
+        block->column_offset[col] = offset;
+        block->stats[col].min = UINT64_MAX;
+        prev = 0;
+
+        for (i = 0; i < writer->row_count; i++)
+        {
+            if (values[i] < block->stats[col].min)
+            {
+                block->stats[col].min = values[i];
+            }
+            if (values[i] > block->stats[col].max)
+            {
+                block->stats[col].max = values[i];
+            }
+
+            switch (column_encoding[col])
+            {
+                case ENCODING_U32:
+                    word = (uint32_t)values[i];
+                    memcpy(writer->buffer + offset, &word, sizeof(word));
+                    offset += sizeof(word);
+                    break;
+
+                case ENCODING_U8:
+                    writer->buffer[offset++] = (uint8_t)values[i];
+                    break;
+
+                default:
+                    delta = values[i] - prev;
+                    delta = (delta << 1) ^ (0U - (delta >> 63));
+                    prev = values[i];
+                    while (delta >= 0x80U)
+                    {
+                        writer->buffer[offset++] = (uint8_t)(delta | 0x80U);
+                        delta >>= 7;
+                    }
+                    writer->buffer[offset++] = (uint8_t)delta;
+                    break;
+            }
+        }
+
+        block->column_size[col] = offset - block->column_offset[col];
+    }
+
+    while (offset != CHUNK_ALIGN(offset))
+    {
+        writer->buffer[offset++] = 0;
+    }
+    block->chunk.size = offset;
+
+    status = boot_record_archive_write(writer->fd, writer->buffer, offset);
+    if (status == BOOT_RECORD_SUCCESS)
+    {
+        writer->row_count = 0;
+    }
+
+    return status;
+}
+
+/**
+ * Free the memory of a writer
+ */
+static void boot_record_archive_writer_free(boot_record_archive_writer_t *writer)
+{
+    free(writer->names);
+    free(writer->name_slots);
+    free(writer->rows[0]);
+    free(writer->buffer);
+}
+
+/**
+ * Open an archive for appending, creating it if needed
+ */
+boot_record_status_t boot_record_archive_writer_open(boot_record_archive_writer_t *writer,
+                                                     const char *path)
+{
+    boot_record_status_t status = BOOT_RECORD_SUCCESS;
+    boot_record_archive_header_t header;
+    boot_record_archive_t archive;
+    uint32_t valid_size = 0;
+    struct stat st;
+    uint32_t col;
+    uint32_t i;
+
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = -1;
+
+    writer->rows[0] = malloc(BOOT_RECORD_ARCHIVE_COLUMNS * BOOT_RECORD_ARCHIVE_BLOCK_ROWS *
+                             sizeof(uint64_t));
+    writer->buffer = malloc(sizeof(boot_record_archive_block_t) + 8U +
+                            BOOT_RECORD_ARCHIVE_BLOCK_ROWS *
+                            (3U * VARINT_MAX_SIZE + 2U * sizeof(uint32_t) + 1U));
+    if (!writer->rows[0] || !writer->buffer)
+    {
+        boot_record_archive_writer_free(writer);
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+    for (col = 1; col < BOOT_RECORD_ARCHIVE_COLUMNS; col++)
+    {
+        writer->rows[col] = writer->rows[col - 1U] + BOOT_RECORD_ARCHIVE_BLOCK_ROWS;
+    }
+
+    /* Pick up the dictionary and boot count of an existing archive */
+    if (stat(path, &st) == 0 && st.st_size > 0)
+    {
+        status = boot_record_archive_open(&archive, path);
+        if (status != BOOT_RECORD_SUCCESS)
+        {
+            boot_record_archive_writer_free(writer);
+            return status;
+        }
+
+        for (i = 0; i < archive.name_count && status == BOOT_RECORD_SUCCESS; i++)
+        {
+            if (boot_record_archive_intern(writer, archive.names[i]) != i)
+            {
+                status = BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+            }
+        }
+        writer->names_written = writer->name_count;
+        writer->next_boot = archive.boot_count;
+        valid_size = archive.valid_size;
+        boot_record_archive_close(&archive);
+
+        if (status != BOOT_RECORD_SUCCESS)
+        {
+            boot_record_archive_writer_free(writer);
+            return status;
+        }
+    }
+
+    writer->fd = open(path, O_WRONLY | O_CREAT, 0644);
+    if (writer->fd < 0)
+    {
+        boot_record_archive_writer_free(writer);
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if (valid_size)
+    {
+        /* Drop a chunk cut short by an interrupted append */
+        if (ftruncate(writer->fd, valid_size) != 0 ||
+            lseek(writer->fd, 0, SEEK_END) < 0)
+        {
+            status = BOOT_RECORD_ERR_INVALID_PARAMS;
+        }
+    }
+    else
+    {
+        memset(&header, 0, sizeof(header));
+        header.chunk.magic = BOOT_RECORD_ARCHIVE_MAGIC;
+        header.chunk.size = sizeof(header);
+        header.version = BOOT_RECORD_ARCHIVE_VERSION;
+        header.byte_order = BOOT_RECORD_BYTE_ORDER;
+
+        if (ftruncate(writer->fd, 0) != 0)
+        {
+            status = BOOT_RECORD_ERR_INVALID_PARAMS;
+        }
+        else
+        {
+            status = boot_record_archive_write(writer->fd, &header, sizeof(header));
+        }
+    }
+
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        close(writer->fd);
+        boot_record_archive_writer_free(writer);
+    }
+
+    return status;
+}
+
+/**
+ * Append the records of a dump as a new boot
+ */
+boot_record_status_t boot_record_archive_add_dump(boot_record_archive_writer_t *writer,
+                                                  const boot_record_dump_t *dump,
+                                                  uint64_t wall)
+{
+    boot_record_status_t status = BOOT_RECORD_SUCCESS;
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t stages;
+    boot_record_record_iter_t records;
+    boot_record_event_t event;
+    boot_record_tconv_t to_ns;
+    char id_name[BOOT_RECORD_NAME_LEN];
+    const char *name;
+    uint32_t name_index;
+    uint32_t row;
+    uint64_t boot = writer->next_boot++;
+
+    boot_record_stage_iter_init(&stages, dump);
+    while (status == BOOT_RECORD_SUCCESS &&
+           (stage = boot_record_stage_iter_next(&stages)) != NULL)
+    {
+        boot_record_tconv_init(&to_ns, stage, BOOT_RECORD_UNIT_NS);
+        boot_record_record_iter_init(&records, stage);
+
+        while (status == BOOT_RECORD_SUCCESS &&
+               boot_record_record_iter_next_event(&records, &event))
+        {
+            name = event.name;
+            if (!name && event.name_id != BOOT_RECORD_NAME_ID_NONE)
+            {
+                snprintf(id_name, sizeof(id_name), "#%" PRIu32, event.name_id);
+                name = id_name;
+            }
+
+            name_index = boot_record_archive_intern(writer, name ? name : "");
+            if (name_index == BOOT_RECORD_NAME_ID_NONE)
+            {
+                status = BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+                break;
+            }
+
+            row = writer->row_count++;
+            writer->rows[BOOT_RECORD_ARCHIVE_COL_BOOT][row] = boot;
+            writer->rows[BOOT_RECORD_ARCHIVE_COL_WALL][row] = wall;
+            writer->rows[BOOT_RECORD_ARCHIVE_COL_STAGE][row] = stage->record_id;
+            writer->rows[BOOT_RECORD_ARCHIVE_COL_NAME][row] = name_index;
+            writer->rows[BOOT_RECORD_ARCHIVE_COL_KIND][row] = event.kind;
+            writer->rows[BOOT_RECORD_ARCHIVE_COL_TIME][row] =
+                boot_record_tconv_apply(&to_ns, event.time);
+
+            if (writer->row_count == BOOT_RECORD_ARCHIVE_BLOCK_ROWS)
+            {
+                status = boot_record_archive_flush(writer);
+            }
+        }
+    }
+
+    if (status == BOOT_RECORD_SUCCESS && stages.status != BOOT_RECORD_SUCCESS)
+    {
+        status = BOOT_RECORD_ERR_FORMAT;
+    }
+
+    return status;
+}
+
+/**
+ * Write the buffered rows and close an archive opened for appending
+ */
+boot_record_status_t boot_record_archive_writer_close(boot_record_archive_writer_t *writer)
+{
+    boot_record_status_t status;
+
+    status = boot_record_archive_flush(writer);
+    if (close(writer->fd) != 0 && status == BOOT_RECORD_SUCCESS)
+    {
+        status = BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+    boot_record_archive_writer_free(writer);
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = -1;
+
+    return status;
+}
@@ -0,0 +1,350 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_archive.h
+ * \brief Append-only columnar archive of the records of many boots
+ *
+ * An archive file is a sequence of chunks, each starting with a magic and
+ * its size. Records are stored in blocks of up to
+ * BOOT_RECORD_ARCHIVE_BLOCK_ROWS rows, one row per record, with every
+ * column of a block stored separately:
+ *
+ * - boot: serial number of the dump in the archive, delta varint
+ * - wall: time the dump was taken in seconds since the epoch, delta varint
+ * - stage: stage ID, delta varint
+ * - name: index into the name dictionary, 32 bit
+ * - kind: record kind (BOOT_RECORD_KIND_*), 8 bit
+ * - time: record time in nanoseconds, delta varint
+ *
+ * Delta varint columns store the zigzag LEB128 difference to the previous
+ * row of the block, so runs of equal values take a byte per row.
+ *
+ * The block header holds the minimum and maximum of every column, so a scan
+ * skips blocks that can't match its filters and decodes only the columns it
+ * needs. Profile names are stored once in name chunks, each appended before
+ * the first block referring to its names. Appending never rewrites existing
+ * chunks; a chunk cut short by an interrupted append is dropped by the next
+ * writer.
+ */
+
+#ifndef BOOT_RECORD_ARCHIVE_H
+#define BOOT_RECORD_ARCHIVE_H
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stdint.h>
+
+#include "bootrecord_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Chunk magics, "BRAF" file header, "BRAN" names and "BRAB" block
+ */
+#define BOOT_RECORD_ARCHIVE_MAGIC           (0x46415242U)
+#define BOOT_RECORD_ARCHIVE_NAMES_MAGIC     (0x4E415242U)
+#define BOOT_RECORD_ARCHIVE_BLOCK_MAGIC     (0x42415242U)
+
+/**
+ * Archive format version
+ */
+#define BOOT_RECORD_ARCHIVE_VERSION         (1U)
+
+/**
+ * Maximum number of rows of a block
+ */
+#define BOOT_RECORD_ARCHIVE_BLOCK_ROWS      (65536U)
+
+/**
+ * Columns of an archive
+ */
+#define BOOT_RECORD_ARCHIVE_COL_BOOT        (0U)
+#define BOOT_RECORD_ARCHIVE_COL_WALL        (1U)
+#define BOOT_RECORD_ARCHIVE_COL_STAGE       (2U)
+#define BOOT_RECORD_ARCHIVE_COL_NAME        (3U)
+#define BOOT_RECORD_ARCHIVE_COL_KIND        (4U)
+#define BOOT_RECORD_ARCHIVE_COL_TIME        (5U)
+#define BOOT_RECORD_ARCHIVE_COLUMNS         (6U)
+
+/**
+ * Bit of a column in a column mask
+ */
+#define BOOT_RECORD_ARCHIVE_COLUMN(col)     (1U << (col))
+
+/**
+ * Header of every chunk
+ */
+typedef struct
+{
+    /* BOOT_RECORD_ARCHIVE_*MAGIC */
+    uint32_t magic;
+    /* Size of the chunk including this header, a multiple of 8 */
+    uint32_t size;
+} boot_record_archive_chunk_t;
+
+/**
+ * First chunk of an archive
+ */
+typedef struct
+{
+    boot_record_archive_chunk_t chunk;
+    /* BOOT_RECORD_ARCHIVE_VERSION */
+    uint16_t version;
+    /* BOOT_RECORD_BYTE_ORDER of the writer */
+    uint8_t byte_order;
+    uint8_t reserved0;
+    uint32_t reserved1;
+} boot_record_archive_header_t;
+
+/**
+ * Chunk adding names to the dictionary, followed by count names of
+ * BOOT_RECORD_NAME_LEN bytes
+ */
+typedef struct
+{
+    boot_record_archive_chunk_t chunk;
+    /* Dictionary index of the first name, the number of names before */
+    uint32_t first;
+    /* Number of names in the chunk */
+    uint32_t count;
+} boot_record_archive_names_t;
+
+/**
+ * Range of the values of a column in a block
+ */
+typedef struct
+{
+    uint64_t min;
+    uint64_t max;
+} boot_record_archive_range_t;
+
+/**
+ * Chunk holding a block of rows, followed by the column data
+ */
+typedef struct
+{
+    boot_record_archive_chunk_t chunk;
+    /* Number of rows */
+    uint32_t row_count;
+    uint32_t reserved;
+    /* Minimum and maximum of every column */
+    boot_record_archive_range_t stats[BOOT_RECORD_ARCHIVE_COLUMNS];
+    /* Offset of every column from the start of the chunk, and its size */
+    uint32_t column_offset[BOOT_RECORD_ARCHIVE_COLUMNS];
+    uint32_t column_size[BOOT_RECORD_ARCHIVE_COLUMNS];
+} boot_record_archive_block_t;
+
+/**
+ * Archive opened for reading
+ */
+typedef struct
+{
+    /* Mapping of the archive file */
+    boot_record_dump_t dump;
+    /* Dictionary, pointers to the names in place */
+    const char **names;
+    uint32_t name_count;
+    /* Blocks in file order */
+    const boot_record_archive_block_t **blocks;
+    uint32_t block_count;
+    /* Number of boots, one more than the highest serial number */
+    uint64_t boot_count;
+    /* Size of the complete chunks, a longer file has an interrupted append */
+    uint32_t valid_size;
+} boot_record_archive_t;
+
+/**
+ * Filters and columns of a scan
+ */
+typedef struct
+{
+    /* Mask of the columns passed to the row callback */
+    uint32_t columns;
+    /* Inclusive range each column must be in */
+    boot_record_archive_range_t filter[BOOT_RECORD_ARCHIVE_COLUMNS];
+} boot_record_archive_query_t;
+
+/**
+ * Scan counters
+ */
+typedef struct
+{
+    /* Number of blocks read and skipped from their statistics */
+    uint32_t blocks_read;
+    uint32_t blocks_skipped;
+    /* Number of rows passed to the callback */
+    uint64_t rows;
+} boot_record_archive_scan_t;
+
+/**
+ * Callback receiving a row matching a scan, indexed by column; columns not
+ * requested are 0
+ */
+typedef void (*boot_record_archive_row_fn)(const uint64_t *row, void *arg);
+
+/**
+ * Archive opened for appending
+ */
+typedef struct
+{
+    /* File descriptor of the archive */
+    int fd;
+    /* Dictionary, BOOT_RECORD_NAME_LEN bytes per name */
+    char *names;
+    uint32_t name_count;
+    uint32_t name_capacity;
+    /* Number of names already written to the archive */
+    uint32_t names_written;
+    /* Open addressing hash table of name index + 1, 0 for a free slot */
+    uint32_t *name_slots;
+    uint32_t slot_count;
+    /* Serial number of the next boot */
+    uint64_t next_boot;
+    /* Rows of the block being filled, one array per column */
+    uint64_t *rows[BOOT_RECORD_ARCHIVE_COLUMNS];
+    uint32_t row_count;
+    /* Encoding buffer of a block */
+    uint8_t *buffer;
+} boot_record_archive_writer_t;
+
+/* ========================================================================== */
+/*                          Function Declarations                             */
+/* ========================================================================== */
+
+/**
+ * Open an archive for reading
+ *
+ * \param archive Archive to initialize
+ * \param path Archive file
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_INVALID_PARAMS with
+ *         errno set if the file can't be mapped, BOOT_RECORD_ERR_FORMAT if it
+ *         is not an archive, BOOT_RECORD_ERR_INSUFFICIENT_MEM
+ */
+boot_record_status_t boot_record_archive_open(boot_record_archive_t *archive,
+                                              const char *path);
+
+/**
+ * Close an archive opened for reading
+ *
+ * \param archive Archive opened by boot_record_archive_open
+ */
+void boot_record_archive_close(boot_record_archive_t *archive);
+
+/**
+ * Look up the dictionary index of a name
+ *
+ * \param archive Archive to search
+ * \param name Profile name
+ * \return Dictionary index, BOOT_RECORD_NAME_ID_NONE if the name is unknown
+ */
+uint32_t boot_record_archive_find_name(const boot_record_archive_t *archive,
+                                       const char *name);
+
+/**
+ * Initialize a query passing every column of every row
+ *
+ * \param query Query to initialize
+ */
+void boot_record_archive_query_init(boot_record_archive_query_t *query);
+
+/**
+ * Call a function for every row matching a query, in archive order
+ *
+ * Blocks whose statistics rule out a match are skipped. Of the others, only
+ * the filtered columns are decoded first, and the requested ones only for
+ * blocks with a matching row.
+ *
+ * \param archive Archive to scan
+ * \param query Filters and columns
+ * \param fn Function to call
+ * \param arg Opaque argument passed to fn
+ * \param scan Optional pointer to receive the scan counters
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_FORMAT if a column
+ *         is corrupt, BOOT_RECORD_ERR_INSUFFICIENT_MEM
+ */
+boot_record_status_t boot_record_archive_scan(const boot_record_archive_t *archive,
+                                              const boot_record_archive_query_t *query,
+                                              boot_record_archive_row_fn fn,
+                                              void *arg,
+                                              boot_record_archive_scan_t *scan);
+
+/**
+ * Open an archive for appending, creating it if needed
+ *
+ * \param writer Writer to initialize
+ * \param path Archive file
+ * \return BOOT_RECORD_SUCCESS on success, error code as for
+ *         boot_record_archive_open
+ */
+boot_record_status_t boot_record_archive_writer_open(boot_record_archive_writer_t *writer,
+                                                     const char *path);
+
+/**
+ * Append the records of a dump as a new boot
+ *
+ * Rows are buffered and written a block at a time.
+ *
+ * \param writer Writer opened by boot_record_archive_writer_open
+ * \param dump Mapped dump
+ * \param wall Time the dump was taken, in seconds since the epoch
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_FORMAT if a stage
+ *         is invalid, the stages before it are kept;
+ *         BOOT_RECORD_ERR_INVALID_PARAMS with errno set on a write error,
+ *         BOOT_RECORD_ERR_INSUFFICIENT_MEM
+ */
+boot_record_status_t boot_record_archive_add_dump(boot_record_archive_writer_t *writer,
+                                                  const boot_record_dump_t *dump,
+                                                  uint64_t wall);
+
+/**
+ * Write the buffered rows and close an archive opened for appending
+ *
+ * \param writer Writer opened by boot_record_archive_writer_open
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_INVALID_PARAMS with
+ *         errno set on a write error
+ */
+boot_record_status_t boot_record_archive_writer_close(boot_record_archive_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RECORD_ARCHIVE_H */
@@ -0,0 +1,771 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_bench.c
+ * \brief Host benchmarks of the logging functions
+ *
+ * Usage: bootrecord_bench [-j <threads>] [-n <calls>] [<test>...]
+ *        bootrecord_bench [-n <records>] -o <dump.bin>
+ *
+ * Runs the named tests, or all of them, against bootrecord.c built into the
+ * tool and prints the cost of each call in cycles of boot_record_bench_ticks.
+ * The tool supplies boot_record_get_timestamp and boot_record_get_cpu_id,
+ * the latter returning the index of the calling benchmark thread.
+ *
+ * contention: -n calls of boot_record_log_profile on each of 1, 2, 4, ...
+ * up to -j threads, one per online CPU by default, all logging into one
+ * stage. Compares a plain stage behind a spinlock, a stage with
+ * BOOT_RECORD_FLAG_CONCURRENT and per-CPU sub-stages by the median and 99th
+ * percentile latency of a call and by the calls per second of all threads.
+ *
+ * init: time of boot_record_init_ex for regions of 4 KB up to 16 MB, with the
+ * default full clear, BOOT_RECORD_FLAG_LAZY_INIT alone and together with
+ * BOOT_RECORD_FLAG_CONCURRENT. Best of several rounds, in microseconds.
+ *
+ * context: cost of a call of boot_record_log_profile and boot_record_log_id
+ * on the default context against boot_record_ctx_log and
+ * boot_record_ctx_log_id on a context of the tool, both in ring mode so
+ * -n calls never fill the stage. Best of several rounds.
+ *
+ * timestamp: cost of a call of boot_record_timestamp and of
+ * boot_record_log_id, with the time read through the weak
+ * boot_record_get_timestamp hook, or inline when the tool is built with
+ * -DBOOT_RECORD_CONFIG_HEADER=\"bootrecord_bench.h\". Best of several rounds.
+ *
+ * With -o no test is run. The tool writes a synthetic dump of -n profile
+ * records with inline names instead, as input for timing the exporters
+ * with their -b option. Its timestamps are microseconds advancing by a
+ * pseudo-random step, so the dump is the same on every run.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord.h"
+#include "bootrecord_bench.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+#define BENCH_DEFAULT_CALLS                 (100000U)
+#define BENCH_ROUNDS                        (5U)
+#define BENCH_INIT_MAX_SIZE                 (16U * 1024U * 1024U)
+#define BENCH_RING_SIZE                     (64U * 1024U)
+#define BENCH_SYNTH_NAMES                   (16U)
+
+/**
+ * Settings shared by all tests
+ */
+typedef struct
+{
+    /* Maximum number of logging threads */
+    uint32_t threads;
+    /* Logging calls per thread and run */
+    uint32_t calls;
+} bench_config_t;
+
+/**
+ * A named test, returning 0 on success
+ */
+typedef struct
+{
+    const char *name;
+    int (*run)(const bench_config_t *config);
+} bench_test_t;
+
+/**
+ * Ways of sharing one stage between threads
+ */
+typedef enum
+{
+    CONTENTION_LOCK,
+    CONTENTION_ATOMIC,
+    CONTENTION_PER_CPU
+} contention_mode_t;
+
+/**
+ * State of one contention run, shared by its threads
+ */
+typedef struct
+{
+    contention_mode_t mode;
+    uint32_t calls;
+    /* Set to 1 to start the threads, or -1 to have them return at once */
+    int go;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_spinlock_t lock;
+    /* Latency of every call, calls entries per thread */
+    uint64_t *latency;
+    /* Calls that did not return BOOT_RECORD_SUCCESS */
+    uint32_t failed;
+} contention_run_t;
+
+/**
+ * Argument of a contention thread
+ */
+typedef struct
+{
+    contention_run_t *run;
+    uint32_t index;
+    pthread_t thread;
+} contention_thread_t;
+
+/* ========================================================================== */
+/*                          Global Variables                                  */
+/* ========================================================================== */
+
+/* Index of the calling thread, as returned by boot_record_get_cpu_id */
+static __thread uint32_t gbench_cpu;
+
+/* Time returned by boot_record_get_timestamp while a synthetic dump is
+ * written, 0 to read boot_record_bench_ticks */
+static uint64_t gbench_synth_time;
+
+/* Context of the context test, static like one in firmware */
+static boot_records_t gbench_ctx;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+uint64_t boot_record_get_timestamp(void)
+{
+    return gbench_synth_time ? gbench_synth_time : boot_record_bench_ticks();
+}
+
+uint32_t boot_record_get_cpu_id(void)
+{
+    return gbench_cpu;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t va = *(const uint64_t *)a;
+    uint64_t vb = *(const uint64_t *)b;
+
+    return (va > vb) - (va < vb);
+}
+
+static void *contention_thread(void *arg)
+{
+    contention_thread_t *thread = arg;
+    contention_run_t *run = thread->run;
+    uint64_t *latency = run->latency + (size_t)thread->index * run->calls;
+    boot_record_status_t status;
+    uint32_t failed = 0;
+    uint64_t start;
+    uint32_t i;
+
+    gbench_cpu = thread->index;
+
+    pthread_mutex_lock(&run->mutex);
+    while (run->go == 0)
+    {
+        pthread_cond_wait(&run->cond, &run->mutex);
+    }
+    pthread_mutex_unlock(&run->mutex);
+
+    if (run->go < 0)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < run->calls; i++)
+    {
+        start = boot_record_bench_ticks();
+        if (run->mode == CONTENTION_LOCK)
+        {
+            pthread_spin_lock(&run->lock);
+            status = boot_record_log_profile("Contended");
+            pthread_spin_unlock(&run->lock);
+        }
+        else
+        {
+            status = boot_record_log_profile("Contended");
+        }
+        latency[i] = boot_record_bench_ticks() - start;
+
+        if (status != BOOT_RECORD_SUCCESS)
+        {
+            failed++;
+        }
+    }
+
+    __atomic_fetch_add(&run->failed, failed, __ATOMIC_RELAXED);
+
+    return NULL;
+}
+
+/* Log from threads into one stage shared the given way, print a result row */
+static int contention_once(contention_mode_t mode, uint32_t threads,
+                           uint32_t calls)
+{
+    static const char *const names[] = { "lock", "atomic", "per-cpu" };
+    contention_thread_t *workers;
+    boot_record_params_t params;
+    contention_run_t run;
+    size_t total = (size_t)threads * calls;
+    uint64_t size;
+    uint64_t elapsed;
+    void *memory;
+    uint32_t started = 0;
+    uint32_t i;
+    int ret = -1;
+
+    /* Room for every call, plus a header and cache line padding per CPU */
+    size = (uint64_t)total * sizeof(boot_record_profile_t) +
+           (uint64_t)(threads + 1U) *
+           (sizeof(boot_stage_record_t) + 2U * BOOT_RECORD_CACHE_LINE_SIZE);
+    if (size > UINT32_MAX)
+    {
+        fprintf(stderr, "contention: %" PRIu32 " threads of %" PRIu32
+                " calls don't fit in one region\n", threads, calls);
+        return -1;
+    }
+
+    boot_record_params_init(&params);
+    if (mode == CONTENTION_ATOMIC)
+    {
+        params.flags = BOOT_RECORD_FLAG_CONCURRENT;
+    }
+    else if (mode == CONTENTION_PER_CPU)
+    {
+        params.flags = BOOT_RECORD_FLAG_PER_CPU;
+        params.num_cpus = threads;
+    }
+
+    memory = malloc((size_t)size);
+    run.latency = malloc(total * sizeof(*run.latency));
+    workers = calloc(threads, sizeof(*workers));
+    if (!memory || !run.latency || !workers)
+    {
+        perror("malloc");
+        goto done;
+    }
+
+    if (boot_record_init_ex(1, memory, (uint32_t)size, &params) != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "contention: init failed\n");
+        goto done;
+    }
+
+    run.mode = mode;
+    run.calls = calls;
+    run.failed = 0;
+    run.go = 0;
+    pthread_mutex_init(&run.mutex, NULL);
+    pthread_cond_init(&run.cond, NULL);
+    pthread_spin_init(&run.lock, PTHREAD_PROCESS_PRIVATE);
+
+    for (i = 0; i < threads; i++)
+    {
+        workers[i].run = &run;
+        workers[i].index = i;
+        if (pthread_create(&workers[i].thread, NULL, contention_thread,
+                           &workers[i]) != 0)
+        {
+            perror("pthread_create");
+            break;
+        }
+        started++;
+    }
+
+    /* Release all threads together, or none if one could not be started */
+    pthread_mutex_lock(&run.mutex);
+    run.go = (started == threads) ? 1 : -1;
+    elapsed = now_ns();
+    pthread_cond_broadcast(&run.cond);
+    pthread_mutex_unlock(&run.mutex);
+
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+    elapsed = now_ns() - elapsed + 1U;
+
+    pthread_spin_destroy(&run.lock);
+    pthread_cond_destroy(&run.cond);
+    pthread_mutex_destroy(&run.mutex);
+
+    if (started < threads)
+    {
+        goto done;
+    }
+
+    if (run.failed)
+    {
+        fprintf(stderr, "contention: %" PRIu32 " of %zu calls failed\n",
+                run.failed, total);
+        goto done;
+    }
+
+    qsort(run.latency, total, sizeof(*run.latency), compare_u64);
+    printf("%8" PRIu32 " %-8s %10" PRIu64 " %10" PRIu64 " %12.2f\n", threads,
+           names[mode], run.latency[total / 2U],
+           run.latency[total - 1U - total / 100U],
+           (double)total * 1e3 / (double)elapsed);
+    ret = 0;
+
+done:
+    free(workers);
+    free(run.latency);
+    free(memory);
+
+    return ret;
+}
+
+static int bench_contention(const bench_config_t *config)
+{
+    uint32_t threads = 1;
+    int mode;
+
+    printf("contention: %" PRIu32 " calls per thread, latency in %s\n",
+           config->calls, BOOT_RECORD_BENCH_UNIT);
+    printf("%8s %-8s %10s %10s %12s\n", "threads", "mode", "p50", "p99",
+           "Mcalls/s");
+
+    while (threads)
+    {
+        for (mode = CONTENTION_LOCK; mode <= CONTENTION_PER_CPU; mode++)
+        {
+            if (mode == CONTENTION_PER_CPU && threads > BOOT_RECORD_MAX_CPUS)
+            {
+                continue;
+            }
+            if (contention_once((contention_mode_t)mode, threads,
+                                config->calls) != 0)
+            {
+                return -1;
+            }
+        }
+
+        if (threads == config->threads)
+        {
+            break;
+        }
+        threads = (2U * threads < config->threads) ? 2U * threads :
+                  config->threads;
+    }
+
+    return 0;
+}
+
+/* Best time in nanoseconds of one init of a region with the given flags */
+static double init_time(void *memory, uint32_t size, uint32_t flags)
+{
+    boot_record_params_t params;
+    uint32_t reps = BENCH_INIT_MAX_SIZE / size;
+    uint64_t best = UINT64_MAX;
+    uint64_t elapsed;
+    uint32_t round;
+    uint32_t i;
+
+    boot_record_params_init(&params);
+    params.flags = flags;
+
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        elapsed = now_ns();
+        for (i = 0; i < reps; i++)
+        {
+            boot_record_init_ex(1, memory, size, &params);
+        }
+        elapsed = now_ns() - elapsed;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    return (double)best / (double)reps;
+}
+
+static int bench_init(const bench_config_t *config)
+{
+    uint32_t size;
+    void *memory;
+
+    (void)config;
+
+    /* Written once up front, so no run pays for faulting the pages in */
+    memory = malloc(BENCH_INIT_MAX_SIZE);
+    if (!memory)
+    {
+        perror("malloc");
+        return -1;
+    }
+    memset(memory, 0xA5, BENCH_INIT_MAX_SIZE);
+
+    printf("init: microseconds per boot_record_init_ex\n");
+    printf("%10s %10s %10s %12s\n", "size", "full", "lazy", "lazy+conc");
+
+    for (size = 4096U; size <= BENCH_INIT_MAX_SIZE; size *= 16U)
+    {
+        printf("%10" PRIu32 " %10.2f %10.2f %12.2f\n", size,
+               init_time(memory, size, 0) / 1e3,
+               init_time(memory, size, BOOT_RECORD_FLAG_LAZY_INIT) / 1e3,
+               init_time(memory, size, BOOT_RECORD_FLAG_LAZY_INIT |
+                                       BOOT_RECORD_FLAG_CONCURRENT) / 1e3);
+    }
+
+    free(memory);
+
+    return 0;
+}
+
+/* Best ticks per call of one logging function. A non-NULL ctx selects the
+ * context variant; ids select boot_record_log_id over the name variant */
+static double context_time(boot_records_t *ctx, int ids, uint32_t calls)
+{
+    static uint8_t memory[BENCH_RING_SIZE];
+    boot_record_params_t params;
+    uint64_t best = UINT64_MAX;
+    uint64_t elapsed;
+    uint32_t name_id = 0;
+    uint32_t round;
+    uint32_t i;
+
+    boot_record_params_init(&params);
+    params.flags = BOOT_RECORD_FLAG_RING |
+                   (ids ? BOOT_RECORD_FLAG_NAME_IDS : 0U);
+
+    if (ctx)
+    {
+        boot_record_ctx_init_ex(ctx, 1, memory, sizeof(memory), &params);
+        boot_record_ctx_register_name(ctx, "Context", &name_id);
+    }
+    else
+    {
+        boot_record_init_ex(1, memory, sizeof(memory), &params);
+        boot_record_register_name("Context", &name_id);
+    }
+
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        elapsed = boot_record_bench_ticks();
+        for (i = 0; i < calls; i++)
+        {
+            if (ctx && ids)
+            {
+                boot_record_ctx_log_id(ctx, name_id);
+            }
+            else if (ctx)
+            {
+                boot_record_ctx_log(ctx, "Context");
+            }
+            else if (ids)
+            {
+                boot_record_log_id(name_id);
+            }
+            else
+            {
+                boot_record_log_profile("Context");
+            }
+        }
+        elapsed = boot_record_bench_ticks() - elapsed;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    return (double)best / (double)calls;
+}
+
+static int bench_context(const bench_config_t *config)
+{
+    printf("context: %s per call, best of %u rounds of %" PRIu32 " calls\n",
+           BOOT_RECORD_BENCH_UNIT, BENCH_ROUNDS, config->calls);
+    printf("%-10s %10s %10s\n", "function", "global", "context");
+    printf("%-10s %10.1f %10.1f\n", "log",
+           context_time(NULL, 0, config->calls),
+           context_time(&gbench_ctx, 0, config->calls));
+    printf("%-10s %10.1f %10.1f\n", "log_id",
+           context_time(NULL, 1, config->calls),
+           context_time(&gbench_ctx, 1, config->calls));
+
+    return 0;
+}
+
+/* Best ticks per call of boot_record_log_id, or of boot_record_timestamp */
+static double timestamp_time(int log, uint32_t calls)
+{
+    static uint8_t memory[BENCH_RING_SIZE];
+    boot_record_params_t params;
+    uint64_t best = UINT64_MAX;
+    uint64_t elapsed;
+    uint64_t sum = 0;
+    uint32_t name_id = 0;
+    uint32_t round;
+    uint32_t i;
+
+    boot_record_params_init(&params);
+    params.flags = BOOT_RECORD_FLAG_RING | BOOT_RECORD_FLAG_NAME_IDS;
+    boot_record_init_ex(1, memory, sizeof(memory), &params);
+    boot_record_register_name("Timestamp", &name_id);
+
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        elapsed = boot_record_bench_ticks();
+        for (i = 0; i < calls; i++)
+        {
+            if (log)
+            {
+                boot_record_log_id(name_id);
+            }
+            else
+            {
+                sum += boot_record_timestamp();
+            }
+        }
+        elapsed = boot_record_bench_ticks() - elapsed;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    /* Keeps the timestamp loop from being optimized out */
+    __asm__ volatile("" : : "r"(sum));
+
+    return (double)best / (double)calls;
+}
+
+static int bench_timestamp(const bench_config_t *config)
+{
+#ifdef BOOT_RECORD_TIMESTAMP
+    const char *source = "inline";
+#else
+    const char *source = "weak hook";
+#endif
+
+    printf("timestamp: %s per call, best of %u rounds of %" PRIu32 " calls\n",
+           BOOT_RECORD_BENCH_UNIT, BENCH_ROUNDS, config->calls);
+    printf("%-10s %-10s %10s\n", "source", "function", "cost");
+    printf("%-10s %-10s %10.1f\n", source, "timestamp",
+           timestamp_time(0, config->calls));
+    printf("%-10s %-10s %10.1f\n", source, "log_id",
+           timestamp_time(1, config->calls));
+
+    return 0;
+}
+
+/* Write a dump of records profile points with inline names to a file */
+static int write_synth(const char *path, uint32_t records)
+{
+    char names[BENCH_SYNTH_NAMES][BOOT_RECORD_NAME_LEN];
+    uint64_t size = sizeof(boot_stage_record_t) +
+                    (uint64_t)records * sizeof(boot_record_profile_t);
+    uint32_t random = 0x12345678U;
+    uint32_t failed = 0;
+    void *memory;
+    FILE *file;
+    uint32_t i;
+    int ret = -1;
+
+#ifdef BOOT_RECORD_TIMESTAMP
+    /* The inline build stamps records with the host clock */
+    fprintf(stderr, "%s: not written, the inline build has no synthetic "
+            "time\n", path);
+    return -1;
+#endif
+
+    if (size > UINT32_MAX)
+    {
+        fprintf(stderr, "%s: %" PRIu32 " records don't fit in one region\n",
+                path, records);
+        return -1;
+    }
+
+    memory = malloc((size_t)size);
+    if (!memory)
+    {
+        perror("malloc");
+        return -1;
+    }
+
+    for (i = 0; i < BENCH_SYNTH_NAMES; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "Synthetic_Point_%02" PRIu32, i);
+    }
+
+    gbench_synth_time = 1000U;
+    boot_record_init(1, memory, (uint32_t)size);
+    for (i = 0; i < records; i++)
+    {
+        /* xorshift32, for steps of 1 to 256 us */
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        gbench_synth_time += 1U + (random & 0xFFU);
+
+        if (boot_record_log_profile(names[i % BENCH_SYNTH_NAMES]) != BOOT_RECORD_SUCCESS)
+        {
+            failed++;
+        }
+    }
+    gbench_synth_time = 0;
+
+    file = fopen(path, "wb");
+    if (failed)
+    {
+        fprintf(stderr, "%s: %" PRIu32 " records failed\n", path, failed);
+    }
+    else if (!file || fwrite(memory, (size_t)size, 1, file) != 1)
+    {
+        perror(path);
+    }
+    else
+    {
+        printf("%s: %" PRIu32 " records, %" PRIu64 " bytes\n", path, records,
+               size);
+        ret = 0;
+    }
+
+    if (file && fclose(file) != 0 && ret == 0)
+    {
+        perror(path);
+        ret = -1;
+    }
+    free(memory);
+
+    return ret;
+}
+
+static const bench_test_t gbench_tests[] =
+{
+    { "contention", bench_contention },
+    { "init", bench_init },
+    { "context", bench_context },
+    { "timestamp", bench_timestamp },
+};
+
+#define BENCH_TEST_COUNT    (sizeof(gbench_tests) / sizeof(gbench_tests[0]))
+
+int main(int argc, char **argv)
+{
+    bench_config_t config = { 0, BENCH_DEFAULT_CALLS };
+    const char *synth = NULL;
+    long online;
+    int status = 0;
+    int arg = 1;
+    int found;
+    uint32_t i;
+
+    while (arg < argc && argv[arg][0] == '-')
+    {
+        if (strcmp(argv[arg], "-j") == 0 && arg + 1 < argc)
+        {
+            config.threads = (uint32_t)strtoul(argv[arg + 1], NULL, 0);
+            arg += 2;
+        }
+        else if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc)
+        {
+            config.calls = (uint32_t)strtoul(argv[arg + 1], NULL, 0);
+            arg += 2;
+        }
+        else if (strcmp(argv[arg], "-o") == 0 && arg + 1 < argc)
+        {
+            synth = argv[arg + 1];
+            arg += 2;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-j <threads>] [-n <calls>] [<test>...]\n"
+                    "       %s [-n <records>] -o <dump.bin>\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    if (config.threads == 0U)
+    {
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+        config.threads = (online > 0) ? (uint32_t)online : 1U;
+    }
+    if (config.calls == 0U)
+    {
+        config.calls = BENCH_DEFAULT_CALLS;
+    }
+
+    if (synth)
+    {
+        return (write_synth(synth, config.calls) != 0);
+    }
+
+    for (i = 0; i < BENCH_TEST_COUNT && arg >= argc; i++)
+    {
+        status |= (gbench_tests[i].run(&config) != 0);
+    }
+
+    for (; arg < argc; arg++)
+    {
+        found = 0;
+        for (i = 0; i < BENCH_TEST_COUNT; i++)
+        {
+            if (strcmp(argv[arg], gbench_tests[i].name) == 0)
+            {
+                status |= (gbench_tests[i].run(&config) != 0);
+                found = 1;
+            }
+        }
+        if (!found)
+        {
+            fprintf(stderr, "%s: unknown test\n", argv[arg]);
+            status = 1;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_bench.h
+ * \brief Cycle-level clock of the host benchmarks
+ *
+ * Reads the fastest monotonic counter of the host: the time stamp counter on
+ * x86, the virtual counter on AArch64, else CLOCK_MONOTONIC in nanoseconds.
+ *
+ * Also serves as the config header of the inline build of bootrecord_bench,
+ * with -DBOOT_RECORD_CONFIG_HEADER=\"bootrecord_bench.h\". The library then
+ * reads the same clock through BOOT_RECORD_TIMESTAMP() instead of calling
+ * boot_record_get_timestamp.
+ */
+
+#ifndef BOOT_RECORD_BENCH_H
+#define BOOT_RECORD_BENCH_H
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__aarch64__)
+#include <time.h>
+#endif
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Unit of boot_record_bench_ticks, for the column headers */
+#if defined(__x86_64__) || defined(__i386__)
+#define BOOT_RECORD_BENCH_UNIT              "cycles"
+#elif defined(__aarch64__)
+#define BOOT_RECORD_BENCH_UNIT              "ticks"
+#else
+#define BOOT_RECORD_BENCH_UNIT              "ns"
+#endif
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Read the benchmark clock
+ *
+ * \return Current value of the clock, in BOOT_RECORD_BENCH_UNIT
+ */
+static inline uint64_t boot_record_bench_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#ifdef BOOT_RECORD_CONFIG_HEADER
+#define BOOT_RECORD_TIMESTAMP()             boot_record_bench_ticks()
+#endif
+
+#endif /* BOOT_RECORD_BENCH_H */
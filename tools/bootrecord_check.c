@@ -0,0 +1,659 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_check.c
+ * \brief Host self-check of the logging functions against the reader library
+ *
+ * Usage: bootrecord_check [-o <directory>]
+ *
+ * Logs records with boot_record_log_profile into stages of every layout:
+ * plain, name IDs, per-CPU sub-stages, ring, compact, record stream, lazy
+ * init over stale memory and a chain of three stages. Each dump is written
+ * to a file, read back with boot_record_dump_open and the stage and record
+ * iterators, and every record is compared with what was logged: name,
+ * timestamp and CPU. With -o the dumps are kept in the directory, otherwise
+ * they are written to temporary files and removed.
+ *
+ * The tool supplies boot_record_get_counter, a simulated 32-bit counter
+ * that wraps during the check, and boot_record_get_cpu_id. A last check
+ * drives the counter through many wraps in random steps below 2^30, reads
+ * it at and around the half period boundaries and from a simulated
+ * interrupt taken inside the counter read, and compares every
+ * boot_record_timestamp with the true 64-bit time.
+ *
+ * Prints one line per check and exits with 1 if any check failed.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_reader.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+#define CHECK_REGION_SIZE                   (16U * 1024U)
+#define CHECK_MAX_STAGES                    (3U)
+#define CHECK_MAX_RECORDS                   (1024U)
+#define CHECK_NUM_CPUS                      (4U)
+#define CHECK_COUNTER_WRAPS                 (10000U)
+
+/**
+ * A record as it was logged
+ */
+typedef struct
+{
+    const char *name;
+    uint64_t time;
+    uint32_t cpu_id;
+} check_record_t;
+
+/**
+ * A stage as it was logged, records in logging order
+ */
+typedef struct
+{
+    uint32_t stage_id;
+    uint32_t flags;
+    check_record_t records[CHECK_MAX_RECORDS];
+    uint32_t count;
+} check_stage_t;
+
+/**
+ * A dump as it was logged
+ */
+typedef struct
+{
+    check_stage_t stages[CHECK_MAX_STAGES];
+    uint32_t stage_count;
+} check_dump_t;
+
+/**
+ * A round-trip check, logging into memory and describing what it logged
+ */
+typedef struct
+{
+    const char *name;
+    int (*generate)(uint8_t *memory, check_dump_t *expected);
+} check_layout_t;
+
+/* ========================================================================== */
+/*                          Global Variables                                  */
+/* ========================================================================== */
+
+/* True time in counter ticks, boot_record_get_counter returns its low half */
+static uint64_t gcheck_time = 0xFFF00000ULL;
+
+/* Set to take a simulated interrupt in the next counter read, which
+ * advances the time by gcheck_irq_step and reads the timestamp itself */
+static int gcheck_irq;
+static uint64_t gcheck_irq_step;
+
+/* Timestamps read by simulated interrupts that differed from the time */
+static uint32_t gcheck_irq_errors;
+
+/* CPU returned by boot_record_get_cpu_id */
+static uint32_t gcheck_cpu;
+
+/* State of the step generator */
+static uint32_t gcheck_random = 0x12345678U;
+
+/* Profile point names, the last one as long as a concurrent stage allows */
+static const char *const gcheck_names[] =
+{
+    "ROM_Exit", "DDR_Init", "Clock_Setup", "Load_Image", "Auth_Image",
+    "Jump_To_OS", "A", "Name_Of_Twenty_Two_Chr"
+};
+
+#define CHECK_NAME_COUNT    (sizeof(gcheck_names) / sizeof(gcheck_names[0]))
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+uint32_t boot_record_get_counter(void)
+{
+    /* The interrupt lands between the library's load of its half period
+     * count and the counter read, so the interrupted read sees a stale count */
+    if (gcheck_irq)
+    {
+        gcheck_irq = 0;
+        gcheck_time += gcheck_irq_step;
+        if (boot_record_timestamp() != gcheck_time)
+        {
+            gcheck_irq_errors++;
+        }
+    }
+
+    return (uint32_t)gcheck_time;
+}
+
+uint32_t boot_record_get_cpu_id(void)
+{
+    return gcheck_cpu;
+}
+
+static uint32_t check_random(void)
+{
+    gcheck_random ^= gcheck_random << 13;
+    gcheck_random ^= gcheck_random >> 17;
+    gcheck_random ^= gcheck_random << 5;
+
+    return gcheck_random;
+}
+
+/* Start describing a new stage of a dump */
+static check_stage_t *check_add_stage(check_dump_t *expected, uint32_t stage_id,
+                                      uint32_t flags)
+{
+    check_stage_t *stage = &expected->stages[expected->stage_count++];
+
+    stage->stage_id = stage_id;
+    stage->flags = flags;
+    stage->count = 0;
+
+    return stage;
+}
+
+/* Advance the time by a step of a few ticks up to a million, log a record
+ * on a CPU and note it in the stage if the logging succeeded */
+static void check_log(check_stage_t *stage, uint32_t cpu_id)
+{
+    uint32_t step = check_random();
+    const char *name = gcheck_names[step % CHECK_NAME_COUNT];
+    check_record_t *record;
+
+    gcheck_time += (step & 0x100U) ? (step >> 12) : (step >> 24);
+    gcheck_cpu = cpu_id;
+
+    if (boot_record_log_profile(name) == BOOT_RECORD_SUCCESS &&
+        stage->count < CHECK_MAX_RECORDS)
+    {
+        record = &stage->records[stage->count++];
+        record->name = name;
+        record->time = gcheck_time;
+        record->cpu_id = cpu_id;
+    }
+}
+
+/* Log into a single stage with the given flags */
+static int check_single(uint8_t *memory, check_dump_t *expected,
+                        uint32_t flags, uint32_t size, uint32_t records)
+{
+    boot_record_params_t params;
+    check_stage_t *stage;
+    uint32_t i;
+
+    boot_record_params_init(&params);
+    params.flags = flags;
+    params.num_cpus = CHECK_NUM_CPUS;
+    if (boot_record_init_ex(1, memory, size, &params) != BOOT_RECORD_SUCCESS)
+    {
+        return -1;
+    }
+
+    stage = check_add_stage(expected, 1, flags);
+    for (i = 0; i < records; i++)
+    {
+        check_log(stage, (flags & BOOT_RECORD_FLAG_PER_CPU) ?
+                         check_random() % CHECK_NUM_CPUS : 0U);
+    }
+
+    return 0;
+}
+
+static int check_plain(uint8_t *memory, check_dump_t *expected)
+{
+    return check_single(memory, expected, 0, CHECK_REGION_SIZE, 200);
+}
+
+static int check_name_ids(uint8_t *memory, check_dump_t *expected)
+{
+    return check_single(memory, expected, BOOT_RECORD_FLAG_NAME_IDS,
+                        CHECK_REGION_SIZE, 200);
+}
+
+static int check_per_cpu(uint8_t *memory, check_dump_t *expected)
+{
+    return check_single(memory, expected, BOOT_RECORD_FLAG_PER_CPU,
+                        CHECK_REGION_SIZE, 200);
+}
+
+/* A small ring, so it wraps several times */
+static int check_ring(uint8_t *memory, check_dump_t *expected)
+{
+    return check_single(memory, expected, BOOT_RECORD_FLAG_RING, 2048, 300);
+}
+
+static int check_compact(uint8_t *memory, check_dump_t *expected)
+{
+    return check_single(memory, expected,
+                        BOOT_RECORD_FLAG_NAME_IDS | BOOT_RECORD_FLAG_COMPACT,
+                        CHECK_REGION_SIZE, 500);
+}
+
+/* Enough records for several stream blocks */
+static int check_stream(uint8_t *memory, check_dump_t *expected)
+{
+    return check_single(memory, expected,
+                        BOOT_RECORD_FLAG_NAME_IDS | BOOT_RECORD_FLAG_STREAM,
+                        CHECK_REGION_SIZE, 1000);
+}
+
+/* Unused slots keep the garbage that was in memory before the init */
+static int check_lazy(uint8_t *memory, check_dump_t *expected)
+{
+    memset(memory, 0xA5, CHECK_REGION_SIZE);
+
+    return check_single(memory, expected, BOOT_RECORD_FLAG_LAZY_INIT,
+                        CHECK_REGION_SIZE, 50);
+}
+
+/* Three stages of different layouts appended to one chain */
+static int check_chain(uint8_t *memory, check_dump_t *expected)
+{
+    static const uint32_t flags[CHECK_MAX_STAGES] =
+    {
+        0,
+        BOOT_RECORD_FLAG_NAME_IDS | BOOT_RECORD_FLAG_COMPACT,
+        BOOT_RECORD_FLAG_NAME_IDS | BOOT_RECORD_FLAG_STREAM
+    };
+    boot_record_params_t params;
+    check_stage_t *stage;
+    uint32_t s;
+    uint32_t i;
+
+    if (boot_record_chain_create(memory, CHECK_REGION_SIZE) != BOOT_RECORD_SUCCESS)
+    {
+        return -1;
+    }
+
+    for (s = 0; s < CHECK_MAX_STAGES; s++)
+    {
+        boot_record_params_init(&params);
+        params.flags = flags[s];
+        if (boot_record_chain_init(s + 1U, memory, 4096, &params) != BOOT_RECORD_SUCCESS)
+        {
+            return -1;
+        }
+
+        stage = check_add_stage(expected, s + 1U, flags[s]);
+        for (i = 0; i < 50; i++)
+        {
+            check_log(stage, 0);
+        }
+    }
+
+    return 0;
+}
+
+/* Compare the records of a stage read back with the ones logged, in the
+ * order of the reader: per CPU, and only the newest ones of a ring */
+static int check_records(const char *layout, const boot_stage_record_t *top,
+                         const check_stage_t *stage)
+{
+    boot_record_record_iter_t iter;
+    boot_record_event_t event;
+    const check_record_t *record;
+    uint32_t cpu_count = (stage->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+                         CHECK_NUM_CPUS : 1U;
+    uint32_t first = 0;
+    uint32_t read = 0;
+    uint32_t cpu;
+    uint32_t i;
+
+    if ((stage->flags & BOOT_RECORD_FLAG_RING) &&
+        stage->count > top->possible_records)
+    {
+        first = stage->count - top->possible_records;
+    }
+
+    boot_record_record_iter_init(&iter, top);
+
+    for (cpu = 0; cpu < cpu_count; cpu++)
+    {
+        for (i = first; i < stage->count; i++)
+        {
+            record = &stage->records[i];
+            if (record->cpu_id != cpu)
+            {
+                continue;
+            }
+
+            if (!boot_record_record_iter_next_event(&iter, &event))
+            {
+                printf("%s: stage %" PRIu32 ": record %" PRIu32 " missing\n",
+                       layout, stage->stage_id, read);
+                return -1;
+            }
+
+            if (!event.name || strcmp(event.name, record->name) != 0 ||
+                event.time != record->time || event.cpu_id != cpu)
+            {
+                printf("%s: stage %" PRIu32 ": record %" PRIu32 " is %s %" PRIu64
+                       " on CPU %" PRIu32 ", logged %s %" PRIu64 " on CPU %" PRIu32 "\n",
+                       layout, stage->stage_id, read,
+                       event.name ? event.name : "(null)", event.time,
+                       event.cpu_id, record->name, record->time, cpu);
+                return -1;
+            }
+            read++;
+        }
+    }
+
+    if (boot_record_record_iter_next_event(&iter, &event))
+    {
+        printf("%s: stage %" PRIu32 ": more than %" PRIu32 " records\n",
+               layout, stage->stage_id, read);
+        return -1;
+    }
+
+    return (int)read;
+}
+
+/* Read a dump file back and compare every stage with the ones logged */
+static int check_dump(const char *layout, const char *path,
+                      const check_dump_t *expected)
+{
+    boot_record_stage_iter_t stages;
+    boot_record_dump_t dump;
+    const boot_stage_record_t *top;
+    uint32_t records = 0;
+    uint32_t s = 0;
+    int ret = 0;
+    int read;
+
+    if (boot_record_dump_open(&dump, path, 0, 0) != BOOT_RECORD_SUCCESS)
+    {
+        printf("%s: %s can't be opened\n", layout, path);
+        return -1;
+    }
+
+    boot_record_stage_iter_init(&stages, &dump);
+    while (ret == 0 && (top = boot_record_stage_iter_next(&stages)) != NULL)
+    {
+        if (s >= expected->stage_count ||
+            top->record_id != expected->stages[s].stage_id)
+        {
+            printf("%s: unexpected stage %" PRIu32 "\n", layout, top->record_id);
+            ret = -1;
+            break;
+        }
+
+        read = check_records(layout, top, &expected->stages[s]);
+        if (read < 0)
+        {
+            ret = -1;
+            break;
+        }
+        records += (uint32_t)read;
+        s++;
+    }
+
+    if (ret == 0 && (stages.status != BOOT_RECORD_SUCCESS ||
+                     s != expected->stage_count))
+    {
+        printf("%s: read %" PRIu32 " of %" PRIu32 " stages, status %d\n",
+               layout, s, expected->stage_count, (int)stages.status);
+        ret = -1;
+    }
+
+    if (ret == 0)
+    {
+        printf("%s: %" PRIu32 " stages, %" PRIu32 " records ok\n", layout, s,
+               records);
+    }
+
+    boot_record_dump_close(&dump);
+
+    return ret;
+}
+
+/* Log one layout, write the dump to a file and read it back */
+static int check_layout(const check_layout_t *layout, const char *dir)
+{
+    static uint8_t memory[CHECK_REGION_SIZE];
+    static check_dump_t expected;
+    char path[4096];
+    FILE *file;
+    int fd = -1;
+    int ret;
+
+    memset(memory, 0, sizeof(memory));
+    memset(&expected, 0, sizeof(expected));
+
+    if (layout->generate(memory, &expected) != 0)
+    {
+        printf("%s: init failed\n", layout->name);
+        return -1;
+    }
+
+    if (dir)
+    {
+        snprintf(path, sizeof(path), "%s/%s.bin", dir, layout->name);
+        file = fopen(path, "wb");
+    }
+    else
+    {
+        snprintf(path, sizeof(path), "%s/bootrecord_check_XXXXXX",
+                 getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp");
+        fd = mkstemp(path);
+        file = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+    }
+
+    if (!file)
+    {
+        perror(path);
+        if (fd >= 0)
+        {
+            close(fd);
+            unlink(path);
+        }
+        return -1;
+    }
+
+    if (fwrite(memory, sizeof(memory), 1, file) != 1 || fclose(file) != 0)
+    {
+        perror(path);
+        if (!dir)
+        {
+            unlink(path);
+        }
+        return -1;
+    }
+
+    ret = check_dump(layout->name, path, &expected);
+
+    if (!dir)
+    {
+        unlink(path);
+    }
+
+    return ret;
+}
+
+/* Read the timestamp and compare it with the true time */
+static int check_read(void)
+{
+    uint64_t time = boot_record_timestamp();
+
+    if (time != gcheck_time)
+    {
+        printf("counter: read 0x%" PRIx64 " at time 0x%" PRIx64 "\n", time,
+               gcheck_time);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Advance the time to the next one with the given low half, in steps of
+ * less than a half period, and read it there */
+static int check_read_at(uint32_t low)
+{
+    uint32_t step = low - (uint32_t)gcheck_time;
+
+    if (step >= 0x80000000U)
+    {
+        gcheck_time += step / 2U;
+        if (check_read() != 0)
+        {
+            return -1;
+        }
+        step -= step / 2U;
+    }
+    gcheck_time += step;
+
+    return check_read();
+}
+
+/* Read the timestamp with an interrupt of step ticks taken inside the read */
+static int check_read_irq(uint64_t step)
+{
+    gcheck_irq = 1;
+    gcheck_irq_step = step;
+
+    return check_read();
+}
+
+/* Drive the counter through many wraps and compare every extended read
+ * with the true 64-bit time */
+static int check_counter(void)
+{
+    static const uint32_t edges[] = { 0x7FFFFFFFU, 0x80000000U, 0xFFFFFFFFU, 0U };
+    uint64_t end = gcheck_time + ((uint64_t)CHECK_COUNTER_WRAPS << 32);
+    uint64_t reads = 0;
+    uint32_t i;
+
+    gcheck_irq_errors = 0;
+
+    while (gcheck_time < end)
+    {
+        /* Random steps below 2^30, a few per half period */
+        for (i = 0; i < 8U; i++)
+        {
+            gcheck_time += check_random() >> 2;
+            if (check_read() != 0)
+            {
+                return -1;
+            }
+        }
+
+        /* Exactly at both sides of each half period boundary */
+        for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+        {
+            if (check_read_at(edges[i]) != 0)
+            {
+                return -1;
+            }
+        }
+
+        /* Interrupts crossing the next boundary inside the read, with the
+         * time a few ticks before it, and not crossing it */
+        if (check_read_at(0x7FFFFFF0U + (check_random() & 0xFU)) != 0 ||
+            check_read_irq(1U + (check_random() & 0x1FU)) != 0 ||
+            check_read_irq(check_random() >> 2) != 0 ||
+            check_read_at(0xFFFFFFF0U + (check_random() & 0xFU)) != 0 ||
+            check_read_irq(1U + (check_random() & 0x1FU)) != 0)
+        {
+            return -1;
+        }
+
+        reads += 8U + sizeof(edges) / sizeof(edges[0]) + 5U;
+    }
+
+    if (gcheck_irq_errors)
+    {
+        printf("counter: %" PRIu32 " reads from interrupts differed\n",
+               gcheck_irq_errors);
+        return -1;
+    }
+
+    printf("counter: %u wraps, %" PRIu64 " reads ok\n", CHECK_COUNTER_WRAPS,
+           reads);
+
+    return 0;
+}
+
+static const check_layout_t gcheck_layouts[] =
+{
+    { "plain", check_plain },
+    { "name_ids", check_name_ids },
+    { "per_cpu", check_per_cpu },
+    { "ring", check_ring },
+    { "compact", check_compact },
+    { "stream", check_stream },
+    { "lazy_init", check_lazy },
+    { "chain", check_chain },
+};
+
+#define CHECK_LAYOUT_COUNT  (sizeof(gcheck_layouts) / sizeof(gcheck_layouts[0]))
+
+int main(int argc, char **argv)
+{
+    const char *dir = NULL;
+    int status = 0;
+    uint32_t i;
+
+    if (argc == 3 && strcmp(argv[1], "-o") == 0)
+    {
+        dir = argv[2];
+    }
+    else if (argc != 1)
+    {
+        fprintf(stderr, "usage: %s [-o <directory>]\n", argv[0]);
+        return 2;
+    }
+
+    for (i = 0; i < CHECK_LAYOUT_COUNT; i++)
+    {
+        if (check_layout(&gcheck_layouts[i], dir) != 0)
+        {
+            status = 1;
+        }
+    }
+
+    if (check_counter() != 0)
+    {
+        status = 1;
+    }
+
+    return status;
+}
@@ -0,0 +1,312 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_critical.c
+ * \brief Host tool reporting the critical path of a multi-core boot
+ *
+ * Usage: bootrecord_critical <dump.bin>...
+ *
+ * For each dump, prints the chain of records that decided the total boot
+ * time, with the time each step added and whether it followed the previous
+ * record of its CPU, the end of the previous stage or a record it waited
+ * for. Then lists the other paths, runs of records of one CPU off the
+ * critical path, with their slack: how much longer they could take without
+ * making the boot longer. Shortening only the critical path shortens boot.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_dag.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Run of consecutive records of one CPU off the critical path
+ */
+typedef struct
+{
+    uint32_t first;
+    uint32_t last;
+    uint32_t count;
+    uint64_t slack;
+} slack_run_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+static const char *edge_name(const boot_record_dag_node_t *node)
+{
+    if (node->critical_pred == BOOT_RECORD_DAG_NONE)
+    {
+        return "start";
+    }
+
+    switch (node->critical_edge)
+    {
+        case BOOT_RECORD_DAG_EDGE_STAGE:
+            return "stage";
+        case BOOT_RECORD_DAG_EDGE_WAIT:
+            return "wait";
+        default:
+            return "cpu";
+    }
+}
+
+/* Label a profile point with its kind, as bootrecord_stats does */
+static const char *label(char *buf, size_t size, const boot_record_dag_node_t *node)
+{
+    snprintf(buf, size, "%s%s", node->name,
+             (node->kind == BOOT_RECORD_KIND_BEGIN) ? "[" :
+             (node->kind == BOOT_RECORD_KIND_END) ? "]" : "");
+    return buf;
+}
+
+static int compare_runs(const void *a, const void *b)
+{
+    const slack_run_t *ra = a;
+    const slack_run_t *rb = b;
+
+    if (ra->slack != rb->slack)
+    {
+        return (ra->slack < rb->slack) ? -1 : 1;
+    }
+
+    return (ra->first < rb->first) ? -1 : (ra->first > rb->first);
+}
+
+static void print_critical_path(const boot_record_dag_t *dag)
+{
+    const boot_record_dag_node_t *node;
+    char name[BOOT_RECORD_NAME_LEN + 1U];
+    uint32_t *path;
+    uint32_t length = 0;
+    uint32_t count;
+    uint32_t i;
+
+    for (i = dag->end; i != BOOT_RECORD_DAG_NONE; i = dag->nodes[i].critical_pred)
+    {
+        length++;
+    }
+
+    path = malloc((length + 1U) * sizeof(*path));
+    if (!path)
+    {
+        perror("malloc");
+        return;
+    }
+
+    count = length;
+    for (i = dag->end; i != BOOT_RECORD_DAG_NONE; i = dag->nodes[i].critical_pred)
+    {
+        path[--count] = i;
+    }
+
+    printf("critical path:\n");
+    printf("%12s %12s  %-5s %5s %3s  %s\n", "time ms", "step ms", "after", "stage",
+           "cpu", "name");
+
+    for (i = 0; i < length; i++)
+    {
+        node = &dag->nodes[path[i]];
+        printf("%12.3f %12.3f  %-5s %5" PRIu32 " %3u  %s\n",
+               (double)node->finish / 1e6,
+               (node->critical_pred == BOOT_RECORD_DAG_NONE) ? 0.0 :
+               (double)(node->finish - dag->nodes[node->critical_pred].finish) / 1e6,
+               edge_name(node), node->stage_index, node->cpu_id,
+               label(name, sizeof(name), node));
+    }
+
+    free(path);
+}
+
+static void print_slack(const boot_record_dag_t *dag)
+{
+    const boot_record_dag_node_t *node;
+    char from[BOOT_RECORD_NAME_LEN + 1U];
+    char to[BOOT_RECORD_NAME_LEN + 1U];
+    slack_run_t *runs;
+    uint32_t *run_of;
+    uint32_t run_count = 0;
+    uint32_t prev;
+    uint32_t i;
+    slack_run_t *run;
+
+    runs = malloc((dag->node_count + 1U) * sizeof(*runs));
+    run_of = malloc((dag->node_count + 1U) * sizeof(*run_of));
+    if (!runs || !run_of)
+    {
+        perror("malloc");
+        free(runs);
+        free(run_of);
+        return;
+    }
+
+    /* A run continues along the CPU edge while records stay off the
+     * critical path */
+    for (i = 0; i < dag->node_count; i++)
+    {
+        node = &dag->nodes[i];
+        run_of[i] = BOOT_RECORD_DAG_NONE;
+        if (node->critical)
+        {
+            continue;
+        }
+
+        prev = node->pred[BOOT_RECORD_DAG_EDGE_CPU];
+        if (prev != BOOT_RECORD_DAG_NONE && run_of[prev] != BOOT_RECORD_DAG_NONE)
+        {
+            run_of[i] = run_of[prev];
+            run = &runs[run_of[i]];
+            run->last = i;
+            run->count++;
+            if (node->slack < run->slack)
+            {
+                run->slack = node->slack;
+            }
+        }
+        else
+        {
+            run_of[i] = run_count;
+            run = &runs[run_count++];
+            run->first = i;
+            run->last = i;
+            run->count = 1;
+            run->slack = node->slack;
+        }
+    }
+
+    qsort(runs, run_count, sizeof(*runs), compare_runs);
+
+    printf("other paths:\n");
+    printf("%12s %5s %3s %8s  %s\n", "slack ms", "stage", "cpu", "records",
+           "from .. to");
+    for (i = 0; i < run_count; i++)
+    {
+        run = &runs[i];
+        node = &dag->nodes[run->first];
+        printf("%12.3f %5" PRIu32 " %3u %8" PRIu32 "  %s .. %s\n",
+               (double)run->slack / 1e6, node->stage_index, node->cpu_id,
+               run->count, label(from, sizeof(from), node),
+               label(to, sizeof(to), &dag->nodes[run->last]));
+    }
+
+    free(runs);
+    free(run_of);
+}
+
+static int analyze_dump(const char *path)
+{
+    boot_record_status_t status;
+    boot_record_dump_t dump;
+    boot_record_dag_t dag;
+    uint32_t critical = 0;
+    uint32_t i;
+
+    if (boot_record_dump_open(&dump, path, 0, 0) != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    status = boot_record_dag_build(&dag, &dump);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", path, (status == BOOT_RECORD_ERR_FORMAT) ?
+                "not a valid boot record dump" : strerror(ENOMEM));
+        boot_record_dump_close(&dump);
+        return -1;
+    }
+
+    if (dag.end == BOOT_RECORD_DAG_NONE)
+    {
+        printf("%s: no records\n", path);
+    }
+    else
+    {
+        for (i = 0; i < dag.node_count; i++)
+        {
+            critical += dag.nodes[i].critical;
+        }
+
+        printf("%s: boot %.3f ms, %" PRIu32 " of %" PRIu32 " records on the critical path\n",
+               path, (double)dag.nodes[dag.end].finish / 1e6, critical, dag.node_count);
+        if (dag.unresolved)
+        {
+            printf("%" PRIu32 " wait records name no earlier record\n", dag.unresolved);
+        }
+
+        print_critical_path(&dag);
+        print_slack(&dag);
+    }
+
+    boot_record_dag_free(&dag);
+    boot_record_dump_close(&dump);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int status = 0;
+    int i;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <dump.bin>...\n", argv[0]);
+        return 2;
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        if (i > 1)
+        {
+            printf("\n");
+        }
+        if (analyze_dump(argv[i]) != 0)
+        {
+            status = 1;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,411 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_dag.c
+ * \brief Dependency graph of the records of a boot, with critical path and
+ *        slack
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_dag.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Node being collected, with what is needed to sort and link it
+ */
+typedef struct
+{
+    boot_record_dag_node_t node;
+    /* Name of the awaited record of a wait record */
+    char wait_name[BOOT_RECORD_NAME_LEN];
+    /* Collection order, keeps the logging order of records of equal time */
+    uint32_t seq;
+} boot_record_dag_entry_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Copy a record name into a zero padded buffer, "#<id>" if unknown
+ */
+static void boot_record_dag_name(char *dst, const char *name, uint32_t name_id)
+{
+    memset(dst, 0, BOOT_RECORD_NAME_LEN);
+    if (name)
+    {
+        strncpy(dst, name, BOOT_RECORD_NAME_LEN - 1U);
+    }
+    else if (name_id != BOOT_RECORD_NAME_ID_NONE)
+    {
+        snprintf(dst, BOOT_RECORD_NAME_LEN, "#%" PRIu32, name_id);
+    }
+}
+
+/**
+ * Order nodes by stage, time, CPU and logging order
+ */
+static int boot_record_dag_compare(const void *a, const void *b)
+{
+    const boot_record_dag_entry_t *ea = a;
+    const boot_record_dag_entry_t *eb = b;
+
+    if (ea->node.stage_index != eb->node.stage_index)
+    {
+        return (ea->node.stage_index < eb->node.stage_index) ? -1 : 1;
+    }
+    if (ea->node.time != eb->node.time)
+    {
+        return (ea->node.time < eb->node.time) ? -1 : 1;
+    }
+    if (ea->node.cpu_id != eb->node.cpu_id)
+    {
+        return (ea->node.cpu_id < eb->node.cpu_id) ? -1 : 1;
+    }
+
+    return (ea->seq < eb->seq) ? -1 : (ea->seq > eb->seq);
+}
+
+/**
+ * Collect the records of every stage of a dump as unlinked nodes
+ */
+static boot_record_status_t boot_record_dag_collect(const boot_record_dump_t *dump,
+                                                    boot_record_dag_entry_t **entries,
+                                                    uint32_t *count)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t stages;
+    boot_record_record_iter_t records;
+    boot_record_dag_entry_t *entry;
+    boot_record_event_t event;
+    boot_record_tconv_t to_ns;
+    uint32_t stage_index = 0;
+    uint32_t capacity = 0;
+    void *grown;
+
+    *entries = NULL;
+    *count = 0;
+
+    boot_record_stage_iter_init(&stages, dump);
+    while ((stage = boot_record_stage_iter_next(&stages)) != NULL)
+    {
+        boot_record_tconv_init(&to_ns, stage, BOOT_RECORD_UNIT_NS);
+        boot_record_record_iter_init(&records, stage);
+
+        while (boot_record_record_iter_next_event(&records, &event))
+        {
+            if (*count == capacity)
+            {
+                capacity = capacity ? 2U * capacity : 1024U;
+                grown = realloc(*entries, capacity * sizeof(**entries));
+                if (!grown)
+                {
+                    return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+                }
+                *entries = grown;
+            }
+
+            entry = &(*entries)[*count];
+            memset(entry, 0, sizeof(*entry));
+            boot_record_dag_name(entry->node.name, event.name, event.name_id);
+            if (event.kind == BOOT_RECORD_KIND_WAIT)
+            {
+                boot_record_dag_name(entry->wait_name,
+                                     boot_record_get_name(records.current, event.wait_id),
+                                     event.wait_id);
+            }
+            entry->node.time = boot_record_tconv_apply(&to_ns, event.time);
+            entry->node.kind = (uint8_t)event.kind;
+            entry->node.cpu_id = (uint8_t)event.cpu_id;
+            entry->node.stage_index = stage_index;
+            entry->seq = (*count)++;
+        }
+
+        stage_index++;
+    }
+
+    return (stages.status == BOOT_RECORD_SUCCESS) ?
+           BOOT_RECORD_SUCCESS : BOOT_RECORD_ERR_FORMAT;
+}
+
+/**
+ * Hash slot of a zero padded name in a table of node indexes + 1
+ */
+static uint32_t boot_record_dag_slot(const boot_record_dag_node_t *nodes,
+                                     const uint32_t *slots, uint32_t mask,
+                                     const char *name)
+{
+    uint32_t hash = 2166136261U;
+    uint32_t slot;
+    uint32_t i;
+
+    for (i = 0; i < BOOT_RECORD_NAME_LEN; i++)
+    {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619U;
+    }
+
+    for (slot = hash & mask; slots[slot]; slot = (slot + 1U) & mask)
+    {
+        if (memcmp(nodes[slots[slot] - 1U].name, name, BOOT_RECORD_NAME_LEN) == 0)
+        {
+            break;
+        }
+    }
+
+    return slot;
+}
+
+/**
+ * Build the dependency graph of the records of a dump and schedule it
+ */
+boot_record_status_t boot_record_dag_build(boot_record_dag_t *dag,
+                                           const boot_record_dump_t *dump)
+{
+    uint32_t last_cpu[BOOT_RECORD_MAX_CPUS];
+    uint32_t stage_last = BOOT_RECORD_DAG_NONE;
+    boot_record_dag_entry_t *entries;
+    boot_record_dag_node_t *node;
+    boot_record_status_t status;
+    uint64_t release;
+    int has_pred;
+    uint32_t *slots = NULL;
+    uint32_t mask = 1;
+    uint32_t slot;
+    uint32_t edge;
+    uint32_t i;
+
+    memset(dag, 0, sizeof(*dag));
+    dag->end = BOOT_RECORD_DAG_NONE;
+
+    status = boot_record_dag_collect(dump, &entries, &dag->node_count);
+
+    /* A dump without records is an empty graph, with nothing to sort */
+    if (status == BOOT_RECORD_SUCCESS && dag->node_count == 0)
+    {
+        free(entries);
+        boot_record_dag_schedule(dag);
+        return BOOT_RECORD_SUCCESS;
+    }
+
+    if (status == BOOT_RECORD_SUCCESS)
+    {
+        while (mask < 2U * dag->node_count)
+        {
+            mask <<= 1;
+        }
+        slots = calloc(mask, sizeof(*slots));
+        dag->nodes = malloc(dag->node_count * sizeof(*dag->nodes));
+        mask--;
+        if (!slots || !dag->nodes)
+        {
+            status = BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+        }
+    }
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        free(entries);
+        free(slots);
+        free(dag->nodes);
+        memset(dag, 0, sizeof(*dag));
+        dag->end = BOOT_RECORD_DAG_NONE;
+        return status;
+    }
+
+    qsort(entries, dag->node_count, sizeof(*entries), boot_record_dag_compare);
+    memset(last_cpu, 0xFF, sizeof(last_cpu));
+
+    /* Predecessors always come earlier in the sorted order */
+    for (i = 0; i < dag->node_count; i++)
+    {
+        node = &dag->nodes[i];
+        *node = entries[i].node;
+
+        if (i > 0 && node->stage_index != dag->nodes[i - 1U].stage_index)
+        {
+            stage_last = i - 1U;
+            memset(last_cpu, 0xFF, sizeof(last_cpu));
+        }
+
+        node->pred[BOOT_RECORD_DAG_EDGE_CPU] = last_cpu[node->cpu_id];
+        node->pred[BOOT_RECORD_DAG_EDGE_STAGE] =
+            (last_cpu[node->cpu_id] == BOOT_RECORD_DAG_NONE) ? stage_last : BOOT_RECORD_DAG_NONE;
+        node->pred[BOOT_RECORD_DAG_EDGE_WAIT] = BOOT_RECORD_DAG_NONE;
+
+        if (node->kind == BOOT_RECORD_KIND_WAIT)
+        {
+            slot = boot_record_dag_slot(dag->nodes, slots, mask, entries[i].wait_name);
+            if (slots[slot])
+            {
+                node->pred[BOOT_RECORD_DAG_EDGE_WAIT] = slots[slot] - 1U;
+            }
+            else
+            {
+                dag->unresolved++;
+            }
+        }
+
+        /* Work starts when the latest predecessor was reached */
+        node->work = 0;
+        release = 0;
+        has_pred = 0;
+        for (edge = 0; edge < BOOT_RECORD_DAG_EDGES; edge++)
+        {
+            if (node->pred[edge] != BOOT_RECORD_DAG_NONE)
+            {
+                has_pred = 1;
+                if (dag->nodes[node->pred[edge]].time > release)
+                {
+                    release = dag->nodes[node->pred[edge]].time;
+                }
+            }
+        }
+        if (has_pred && node->time > release)
+        {
+            node->work = node->time - release;
+        }
+
+        slot = boot_record_dag_slot(dag->nodes, slots, mask, node->name);
+        slots[slot] = i + 1U;
+        last_cpu[node->cpu_id] = i;
+    }
+
+    free(entries);
+    free(slots);
+
+    boot_record_dag_schedule(dag);
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Compute finish times from the work of the nodes, then slack and the
+ * critical path
+ */
+void boot_record_dag_schedule(boot_record_dag_t *dag)
+{
+    boot_record_dag_node_t *node;
+    boot_record_dag_node_t *pred;
+    uint64_t total = 0;
+    uint64_t start;
+    uint32_t edge;
+    uint32_t i;
+
+    dag->end = BOOT_RECORD_DAG_NONE;
+
+    /* Forward: a node finishes its work after its latest predecessor */
+    for (i = 0; i < dag->node_count; i++)
+    {
+        node = &dag->nodes[i];
+        node->critical_pred = BOOT_RECORD_DAG_NONE;
+        node->critical_edge = 0;
+        node->critical = 0;
+        start = 0;
+
+        for (edge = 0; edge < BOOT_RECORD_DAG_EDGES; edge++)
+        {
+            if (node->pred[edge] == BOOT_RECORD_DAG_NONE)
+            {
+                continue;
+            }
+
+            pred = &dag->nodes[node->pred[edge]];
+            if (node->critical_pred == BOOT_RECORD_DAG_NONE || pred->finish > start)
+            {
+                start = pred->finish;
+                node->critical_pred = node->pred[edge];
+                node->critical_edge = (uint8_t)edge;
+            }
+        }
+
+        node->finish = (node->critical_pred == BOOT_RECORD_DAG_NONE) ?
+                       node->time : start + node->work;
+
+        if (node->finish >= total)
+        {
+            total = node->finish;
+            dag->end = i;
+        }
+    }
+
+    /* Backward: every record may be as late as its successors allow, and
+     * records nothing depends on as late as the end of the boot */
+    for (i = 0; i < dag->node_count; i++)
+    {
+        dag->nodes[i].latest = total;
+    }
+
+    for (i = dag->node_count; i-- > 0;)
+    {
+        node = &dag->nodes[i];
+        node->slack = node->latest - node->finish;
+
+        for (edge = 0; edge < BOOT_RECORD_DAG_EDGES; edge++)
+        {
+            if (node->pred[edge] == BOOT_RECORD_DAG_NONE)
+            {
+                continue;
+            }
+
+            pred = &dag->nodes[node->pred[edge]];
+            if (node->latest - node->work < pred->latest)
+            {
+                pred->latest = node->latest - node->work;
+            }
+        }
+    }
+
+    for (i = dag->end; i != BOOT_RECORD_DAG_NONE; i = dag->nodes[i].critical_pred)
+    {
+        dag->nodes[i].critical = 1;
+    }
+}
+
+/**
+ * Free the nodes of a graph
+ */
+void boot_record_dag_free(boot_record_dag_t *dag)
+{
+    free(dag->nodes);
+    memset(dag, 0, sizeof(*dag));
+    dag->end = BOOT_RECORD_DAG_NONE;
+}
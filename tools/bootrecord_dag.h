@@ -0,0 +1,175 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_dag.h
+ * \brief Dependency graph of the records of a boot, with critical path and
+ *        slack
+ *
+ * Every record of every stage and CPU of a dump becomes a node. A node
+ * depends on:
+ *
+ * - the previous record of the same CPU in the same stage
+ * - for the first record of a CPU, the last record of the previous stage
+ * - for a wait record, the latest earlier record named after its wait_id,
+ *   on any CPU and in any stage
+ *
+ * A node's work is the time from its latest predecessor to the node. Once
+ * scheduled, the critical path is the chain of latest predecessors ending
+ * at the last record, and a node's slack is how much later it could be
+ * reached without delaying the last record. Records of a stage without
+ * per-CPU sub-stages form a single chain, even if several cores logged
+ * them.
+ */
+
+#ifndef BOOT_RECORD_DAG_H
+#define BOOT_RECORD_DAG_H
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stdint.h>
+
+#include "bootrecord_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Dependency edges of a node, indexes into boot_record_dag_node_t::pred
+ */
+/* Previous record of the same CPU */
+#define BOOT_RECORD_DAG_EDGE_CPU            (0U)
+/* Last record of the previous stage */
+#define BOOT_RECORD_DAG_EDGE_STAGE          (1U)
+/* Record waited for */
+#define BOOT_RECORD_DAG_EDGE_WAIT           (2U)
+#define BOOT_RECORD_DAG_EDGES               (3U)
+
+/**
+ * Node index reported for a missing predecessor
+ */
+#define BOOT_RECORD_DAG_NONE                (0xFFFFFFFFU)
+
+/**
+ * Record of a boot in the dependency graph
+ */
+typedef struct
+{
+    /* Profile name, "#<id>" if the name table lacks it */
+    char name[BOOT_RECORD_NAME_LEN];
+    /* Logged time in nanoseconds */
+    uint64_t time;
+    /* Time from the latest predecessor to this record, 0 for a node without
+     * predecessors, which is pinned at its logged time */
+    uint64_t work;
+    /* Time computed by boot_record_dag_schedule */
+    uint64_t finish;
+    /* Latest time the record could be reached without delaying the last
+     * record, and the difference to finish */
+    uint64_t latest;
+    uint64_t slack;
+    /* Predecessors by edge (BOOT_RECORD_DAG_EDGE_*), BOOT_RECORD_DAG_NONE
+     * if none */
+    uint32_t pred[BOOT_RECORD_DAG_EDGES];
+    /* Predecessor finishing last, BOOT_RECORD_DAG_NONE for a root */
+    uint32_t critical_pred;
+    /* Edge (BOOT_RECORD_DAG_EDGE_*) to critical_pred */
+    uint8_t critical_edge;
+    /* Record kind (BOOT_RECORD_KIND_*) */
+    uint8_t kind;
+    /* CPU of the record */
+    uint8_t cpu_id;
+    /* Whether the node is on the critical path */
+    uint8_t critical;
+    /* Index of the stage in the dump */
+    uint32_t stage_index;
+} boot_record_dag_node_t;
+
+/**
+ * Dependency graph of one boot
+ */
+typedef struct
+{
+    /* Nodes in topological order: by stage, then time */
+    boot_record_dag_node_t *nodes;
+    uint32_t node_count;
+    /* Last node to finish, BOOT_RECORD_DAG_NONE for an empty graph */
+    uint32_t end;
+    /* Number of wait records whose awaited record was not found */
+    uint32_t unresolved;
+} boot_record_dag_t;
+
+/* ========================================================================== */
+/*                          Function Declarations                             */
+/* ========================================================================== */
+
+/**
+ * Build the dependency graph of the records of a dump and schedule it
+ *
+ * \param dag Graph to initialize
+ * \param dump Mapped dump of one boot
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_FORMAT if a stage
+ *         is invalid, BOOT_RECORD_ERR_INSUFFICIENT_MEM
+ */
+boot_record_status_t boot_record_dag_build(boot_record_dag_t *dag,
+                                           const boot_record_dump_t *dump);
+
+/**
+ * Compute finish times from the work of the nodes, then slack and the
+ * critical path
+ *
+ * Called by boot_record_dag_build; call it again after changing the work
+ * of nodes to see the effect on the boot.
+ *
+ * \param dag Graph built by boot_record_dag_build
+ */
+void boot_record_dag_schedule(boot_record_dag_t *dag);
+
+/**
+ * Free the nodes of a graph
+ *
+ * \param dag Graph built by boot_record_dag_build
+ */
+void boot_record_dag_free(boot_record_dag_t *dag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RECORD_DAG_H */
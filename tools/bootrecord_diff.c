@@ -0,0 +1,411 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_diff.c
+ * \brief Host tool finding checkpoint intervals that changed between two
+ *        sets of boots
+ *
+ * Usage: bootrecord_diff [-j <threads>] [-p <alpha>] <baseline> <candidate>
+ *        bootrecord_diff [-j <threads>] [-p <alpha>] <baseline>... -- <candidate>...
+ *
+ * Baseline and candidate are dump files or directories of dumps, typically
+ * boots of the firmware before and after a change. Intervals between two
+ * consecutive profile points are matched by the names of the points,
+ * whatever the stage they are logged in. For every interval it prints the
+ * medians of both sets, the relative difference of their means and the
+ * p-value of a Mann-Whitney U test. An interval is marked as regressed or
+ * improved when its p-value is below alpha divided by the number of
+ * intervals compared (Bonferroni correction), alpha defaulting to 0.01.
+ * The exit status is 3 if an interval regressed, even if some dumps could
+ * not be read, else 1 if a dump could not be read.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_ingest.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Default significance level */
+#define DEFAULT_ALPHA                       (0.01)
+
+/* Exit status when an interval regressed */
+#define EXIT_REGRESSED                      (3)
+
+/**
+ * Interval of the baseline, the candidate or both
+ */
+typedef struct
+{
+    const boot_record_pair_t *base;
+    const boot_record_pair_t *cand;
+    double p;
+    double z;
+} interval_t;
+
+/**
+ * Intervals being collected
+ */
+typedef struct
+{
+    interval_t *intervals;
+    uint32_t count;
+    /* Aggregate looked up while collecting, NULL to skip the lookup */
+    const boot_record_agg_t *other;
+    /* Whether the pairs walked are candidate pairs */
+    int candidate;
+} interval_list_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+static void report_error(const char *path, boot_record_status_t status,
+                         int error, void *arg)
+{
+    (void)arg;
+
+    if (status == BOOT_RECORD_ERR_INVALID_PARAMS && error)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(error));
+    }
+    else
+    {
+        fprintf(stderr, "%s: not a valid boot record dump\n", path);
+    }
+}
+
+/* Fold a pair into the aggregate of its names, dropping the stage ID */
+static void fold_pair(const boot_record_pair_t *pair, void *arg)
+{
+    boot_record_pair_t key;
+
+    memcpy(&key, pair, offsetof(boot_record_pair_t, sketch));
+    key.stage_id = 0;
+    boot_record_agg_add_sketch(arg, &key, &pair->sketch);
+}
+
+static void collect_interval(const boot_record_pair_t *pair, void *arg)
+{
+    interval_list_t *list = arg;
+    interval_t *interval;
+    const boot_record_pair_t *other;
+
+    other = boot_record_agg_lookup(list->other, pair);
+
+    /* Intervals of both sets are collected with the baseline */
+    if (list->candidate && other)
+    {
+        return;
+    }
+
+    interval = &list->intervals[list->count++];
+    interval->base = list->candidate ? NULL : pair;
+    interval->cand = list->candidate ? pair : other;
+    interval->p = 1.0;
+    interval->z = 0.0;
+    if (interval->base && interval->cand)
+    {
+        interval->p = boot_record_sketch_mann_whitney(&interval->cand->sketch,
+                                                      &interval->base->sketch,
+                                                      &interval->z);
+    }
+}
+
+static int compare_intervals(const void *a, const void *b)
+{
+    const interval_t *ia = a;
+    const interval_t *ib = b;
+
+    if (ia->p != ib->p)
+    {
+        return (ia->p < ib->p) ? -1 : 1;
+    }
+    if (fabs(ia->z) != fabs(ib->z))
+    {
+        return (fabs(ia->z) > fabs(ib->z)) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/* Label a profile point with its kind, as bootrecord_stats does */
+static const char *label(char *buf, size_t size, const char *name, uint8_t kind)
+{
+    snprintf(buf, size, "%s%s", name,
+             (kind == BOOT_RECORD_KIND_BEGIN) ? "[" :
+             (kind == BOOT_RECORD_KIND_END) ? "]" : "");
+    return buf;
+}
+
+static int load_set(boot_record_agg_t *names, char **args, int count,
+                    const boot_record_ingest_params_t *params)
+{
+    boot_record_ingest_result_t result;
+    boot_record_path_list_t list;
+    boot_record_status_t ret;
+    boot_record_agg_t agg;
+    int status = 0;
+    int i;
+
+    boot_record_path_list_init(&list);
+    for (i = 0; i < count; i++)
+    {
+        ret = boot_record_path_list_add(&list, args[i]);
+        if (ret == BOOT_RECORD_ERR_INSUFFICIENT_MEM)
+        {
+            boot_record_path_list_free(&list);
+            return -1;
+        }
+        else if (ret != BOOT_RECORD_SUCCESS)
+        {
+            fprintf(stderr, "%s: %s\n", args[i], strerror(errno));
+            status = 1;
+        }
+    }
+
+    if (boot_record_agg_init(&agg, 0) != BOOT_RECORD_SUCCESS ||
+        boot_record_ingest(&agg, list.paths, list.count, params, &result) != BOOT_RECORD_SUCCESS)
+    {
+        boot_record_path_list_free(&list);
+        return -1;
+    }
+
+    boot_record_agg_foreach(&agg, fold_pair, names);
+    names->stages += agg.stages;
+    names->dropped += agg.dropped;
+    names->rejected += agg.rejected;
+
+    boot_record_agg_free(&agg);
+    boot_record_path_list_free(&list);
+
+    return (result.failed || status) ? 1 : 0;
+}
+
+static int print_diff(const boot_record_agg_t *base, const boot_record_agg_t *cand,
+                      double alpha)
+{
+    char from[BOOT_RECORD_NAME_LEN + 1U];
+    char to[BOOT_RECORD_NAME_LEN + 1U];
+    const boot_record_pair_t *pair;
+    const interval_t *interval;
+    interval_list_t list;
+    uint32_t compared = 0;
+    int regressed = 0;
+    const char *verdict;
+    double threshold;
+    double base_p50;
+    double cand_p50;
+    double delta;
+    uint32_t i;
+
+    list.intervals = malloc((base->pair_count + cand->pair_count + 1U) *
+                            sizeof(*list.intervals));
+    list.count = 0;
+    if (!list.intervals)
+    {
+        return -1;
+    }
+
+    list.other = cand;
+    list.candidate = 0;
+    boot_record_agg_foreach(base, collect_interval, &list);
+    list.other = base;
+    list.candidate = 1;
+    boot_record_agg_foreach(cand, collect_interval, &list);
+    qsort(list.intervals, list.count, sizeof(*list.intervals), compare_intervals);
+
+    for (i = 0; i < list.count; i++)
+    {
+        compared += (list.intervals[i].base && list.intervals[i].cand);
+    }
+    threshold = compared ? alpha / (double)compared : alpha;
+
+    printf("%" PRIu64 " baseline stages, %" PRIu64 " candidate stages, "
+           "%" PRIu32 " intervals compared, significance %.3g\n",
+           base->stages, cand->stages, compared, threshold);
+    printf("%-24s %-24s %9s %9s %12s %12s %8s %9s\n", "from", "to",
+           "n base", "n cand", "p50 base us", "p50 cand us", "mean", "p");
+
+    for (i = 0; i < list.count; i++)
+    {
+        interval = &list.intervals[i];
+        pair = interval->base ? interval->base : interval->cand;
+        base_p50 = interval->base ?
+                   boot_record_sketch_quantile(&interval->base->sketch, 0.5) / 1000.0 : 0.0;
+        cand_p50 = interval->cand ?
+                   boot_record_sketch_quantile(&interval->cand->sketch, 0.5) / 1000.0 : 0.0;
+
+        /* Means are exact, medians only within the sketch accuracy */
+        delta = 0.0;
+        if (interval->base && interval->cand && interval->base->sketch.sum > 0.0)
+        {
+            delta = 100.0 * ((interval->cand->sketch.sum / (double)interval->cand->sketch.count) /
+                             (interval->base->sketch.sum / (double)interval->base->sketch.count) - 1.0);
+        }
+
+        if (!interval->cand)
+        {
+            verdict = "removed";
+        }
+        else if (!interval->base)
+        {
+            verdict = "added";
+        }
+        else if (interval->p < threshold)
+        {
+            verdict = (interval->z > 0.0) ? "regressed" : "improved";
+            regressed |= (interval->z > 0.0);
+        }
+        else
+        {
+            verdict = "";
+        }
+
+        printf("%-24s %-24s %9" PRIu64 " %9" PRIu64 " %12.3f %12.3f %7.1f%% %9.2g %s\n",
+               label(from, sizeof(from), pair->from, pair->from_kind),
+               label(to, sizeof(to), pair->to, pair->to_kind),
+               interval->base ? interval->base->sketch.count : 0U,
+               interval->cand ? interval->cand->sketch.count : 0U,
+               base_p50, cand_p50, delta, interval->p, verdict);
+    }
+
+    free(list.intervals);
+
+    return regressed;
+}
+
+int main(int argc, char **argv)
+{
+    boot_record_ingest_params_t params = { 0 };
+    boot_record_agg_t base;
+    boot_record_agg_t cand;
+    double alpha = DEFAULT_ALPHA;
+    char **cand_args;
+    int base_count;
+    int cand_count;
+    int status = 0;
+    int ret;
+    int arg = 1;
+    int sep;
+
+    params.error_fn = report_error;
+
+    while (arg + 1 < argc && argv[arg][0] == '-' && strcmp(argv[arg], "--") != 0)
+    {
+        if (strcmp(argv[arg], "-j") == 0)
+        {
+            params.threads = (uint32_t)strtoul(argv[arg + 1], NULL, 0);
+        }
+        else if (strcmp(argv[arg], "-p") == 0)
+        {
+            alpha = strtod(argv[arg + 1], NULL);
+        }
+        else
+        {
+            break;
+        }
+        arg += 2;
+    }
+
+    /* Without a separator, exactly one baseline and one candidate */
+    for (sep = arg; sep < argc && strcmp(argv[sep], "--") != 0; sep++)
+    {
+    }
+    if (sep == argc)
+    {
+        sep = (argc - arg == 2) ? arg + 1 : argc;
+        cand_args = argv + sep;
+    }
+    else
+    {
+        cand_args = argv + sep + 1;
+    }
+    base_count = sep - arg;
+    cand_count = (int)(argv + argc - cand_args);
+
+    if (base_count < 1 || cand_count < 1)
+    {
+        fprintf(stderr, "usage: %s [-j <threads>] [-p <alpha>] <baseline> <candidate>\n"
+                "       %s [-j <threads>] [-p <alpha>] <baseline>... -- <candidate>...\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+
+    if (boot_record_agg_init(&base, 0) != BOOT_RECORD_SUCCESS ||
+        boot_record_agg_init(&cand, 0) != BOOT_RECORD_SUCCESS)
+    {
+        perror("malloc");
+        return 1;
+    }
+
+    ret = load_set(&base, argv + arg, base_count, &params);
+    if (ret >= 0)
+    {
+        status |= ret;
+        ret = load_set(&cand, cand_args, cand_count, &params);
+    }
+    if (ret >= 0)
+    {
+        status |= ret;
+        ret = print_diff(&base, &cand, alpha);
+    }
+
+    if (ret < 0)
+    {
+        perror("malloc");
+        status = 1;
+    }
+    else if (ret > 0)
+    {
+        /* A regression outranks unreadable dumps, so gates keyed on it
+         * still see it */
+        status = EXIT_REGRESSED;
+    }
+
+    boot_record_agg_free(&base);
+    boot_record_agg_free(&cand);
+
+    return status;
+}
@@ -0,0 +1,402 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_dump.c
+ * \brief Host tool listing the stages and records of a boot record dump
+ *
+ * Usage: bootrecord_dump [-b] <file> [<offset> <size>]
+ *
+ * Reads a dump file, or with offset and size a reserved-memory range of a
+ * device such as /dev/mem, and prints every record in logging order, one
+ * per-CPU sub-stage after another. With -b it prints no records; it walks
+ * them repeatedly and reports how fast the dump is parsed. For record
+ * streams it also reports the speed of boot_record_stream_decode and of the
+ * vector and scalar prefix sums.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_reader.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Minimum time spent walking the dump with -b */
+#define BENCH_MIN_NS                        (500000000ULL)
+
+/* Values summed per pass with -b, few enough to stay in the cache like the
+ * deltas of a block do */
+#define BENCH_SUM_VALUES                    (4096U)
+
+/**
+ * Record streams of a dump, decoded in bulk with -b
+ */
+typedef struct
+{
+    const boot_stage_record_t *stages[BOOT_RECORD_MAX_STAGES * BOOT_RECORD_MAX_CPUS];
+    uint32_t count;
+    uint64_t records;
+    uint64_t bytes;
+} stream_set_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Print the header and the records of one validated boot stage
+ */
+static void print_stage(const boot_stage_record_t *stage)
+{
+    boot_record_record_iter_t iter;
+    boot_record_event_t event;
+    const boot_stage_record_t *sub;
+    uint32_t count = boot_record_get_count(stage);
+    uint32_t bytes = stage->stream_size;
+    uint32_t cpu;
+
+    for (cpu = 0; (stage->flags & BOOT_RECORD_FLAG_PER_CPU) &&
+                  cpu < stage->cpu_count; cpu++)
+    {
+        sub = boot_record_get_cpu_stage(stage, cpu);
+        if (sub)
+        {
+            count += boot_record_get_count(sub);
+            bytes += sub->stream_size;
+        }
+    }
+
+    /* A stream has blocks instead of record slots */
+    if (stage->flags & BOOT_RECORD_FLAG_STREAM)
+    {
+        printf("stage %" PRIu32 ": %" PRIu32 " records in %" PRIu32 " of %"
+               PRIu32 " stream bytes, start %" PRIu64 " %s\n", stage->record_id,
+               count, bytes, stage->possible_records * stage->record_stride,
+               stage->start_time,
+               stage->time_unit == BOOT_RECORD_TIME_TICKS ? "ticks" : "us");
+    }
+    else
+    {
+        printf("stage %" PRIu32 ": %" PRIu32 " of %" PRIu32 " records, start %"
+               PRIu64 " %s\n", stage->record_id, count,
+               stage->possible_records, stage->start_time,
+               stage->time_unit == BOOT_RECORD_TIME_TICKS ? "ticks" : "us");
+    }
+
+    boot_record_record_iter_init(&iter, stage);
+    while (boot_record_record_iter_next_event(&iter, &event))
+    {
+        printf("%20" PRIu64 "  cpu%-2" PRIu32 "  ", event.time, event.cpu_id);
+
+        if (event.name)
+        {
+            printf("%.*s\n", (int)BOOT_RECORD_NAME_LEN - 1, event.name);
+        }
+        else
+        {
+            printf("#%" PRIu32 "\n", event.name_id);
+        }
+    }
+}
+
+/**
+ * Walk every record of a dump once
+ *
+ * \return 0 on success, -1 if a stage is invalid
+ */
+static int walk_dump(const boot_record_dump_t *dump, uint64_t *records,
+                     uint64_t *checksum)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t stages;
+    boot_record_record_iter_t iter;
+    boot_record_event_t event;
+
+    *records = 0;
+
+    boot_record_stage_iter_init(&stages, dump);
+    while ((stage = boot_record_stage_iter_next(&stages)) != NULL)
+    {
+        boot_record_record_iter_init(&iter, stage);
+        while (boot_record_record_iter_next_event(&iter, &event))
+        {
+            *checksum += event.time;
+            (*records)++;
+        }
+    }
+
+    return (stages.status == BOOT_RECORD_SUCCESS) ? 0 : -1;
+}
+
+/**
+ * Collect the record streams of a dump, stages and per-CPU sub-stages
+ */
+static void find_streams(const boot_record_dump_t *dump, stream_set_t *set)
+{
+    const boot_stage_record_t *stage;
+    const boot_stage_record_t *sub;
+    boot_record_stage_iter_t stages;
+    uint32_t cpu;
+
+    memset(set, 0, sizeof(*set));
+
+    boot_record_stage_iter_init(&stages, dump);
+    while ((stage = boot_record_stage_iter_next(&stages)) != NULL)
+    {
+        if (!(stage->flags & BOOT_RECORD_FLAG_STREAM))
+        {
+            continue;
+        }
+
+        if (!(stage->flags & BOOT_RECORD_FLAG_PER_CPU))
+        {
+            set->stages[set->count++] = stage;
+            set->records += boot_record_get_count(stage);
+            set->bytes += stage->stream_size;
+            continue;
+        }
+
+        for (cpu = 0; cpu < stage->cpu_count; cpu++)
+        {
+            sub = boot_record_get_cpu_stage(stage, cpu);
+            if (sub)
+            {
+                set->stages[set->count++] = sub;
+                set->records += boot_record_get_count(sub);
+                set->bytes += sub->stream_size;
+            }
+        }
+    }
+}
+
+/**
+ * Report how fast the record streams of a dump are decoded in bulk, and how
+ * fast the prefix sums rebuild the timestamps
+ */
+static int bench_streams(const stream_set_t *set)
+{
+    void (*sums[2])(uint64_t *, uint32_t, uint64_t) = {
+        boot_record_prefix_sum, boot_record_prefix_sum_scalar
+    };
+    static const char *const sum_names[2] = { "vector", "scalar" };
+    uint32_t *name_ids;
+    uint64_t *times;
+    uint64_t checksum = 0;
+    uint64_t passes;
+    uint64_t start;
+    uint64_t elapsed;
+    uint64_t offset;
+    uint32_t count;
+    uint32_t i;
+    uint32_t k;
+
+    name_ids = malloc((size_t)set->records * sizeof(*name_ids) + 1U);
+    times = malloc((size_t)set->records * sizeof(*times) + 1U);
+    if (!name_ids || !times)
+    {
+        free(name_ids);
+        free(times);
+        return -1;
+    }
+
+    passes = 0;
+    start = now_ns();
+    do
+    {
+        offset = 0;
+        for (i = 0; i < set->count; i++)
+        {
+            count = boot_record_get_count(set->stages[i]);
+            offset += boot_record_stream_decode(set->stages[i], 0, count,
+                                                name_ids + offset, times + offset);
+        }
+        checksum += offset ? times[offset - 1U] : 0U;
+        passes++;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+
+    printf("stream: %" PRIu64 " records in %" PRIu64 " bytes, %.2f bytes/record\n",
+           set->records, set->bytes, (double)set->bytes / (double)set->records);
+    printf("bulk decode: %.1f Mrecords/s, %.1f MB/s (checksum %" PRIx64 ")\n",
+           (double)(set->records * passes) * 1e3 / (double)elapsed,
+           (double)(set->bytes * passes) * 1e3 / (double)elapsed, checksum);
+
+    /* The sums run over the timestamps again, which only changes the values */
+    count = (set->records < BENCH_SUM_VALUES) ? (uint32_t)set->records : BENCH_SUM_VALUES;
+    for (k = 0; k < 2U; k++)
+    {
+        passes = 0;
+        start = now_ns();
+        do
+        {
+            sums[k](times, count, 0);
+            passes++;
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+
+        printf("%s prefix sum: %.1f Mvalues/s\n", sum_names[k],
+               (double)count * (double)passes * 1e3 / (double)elapsed);
+    }
+
+    free(name_ids);
+    free(times);
+
+    return 0;
+}
+
+/**
+ * Report how fast the records of a dump are parsed
+ */
+static int bench_dump(const boot_record_dump_t *dump)
+{
+    stream_set_t streams;
+    uint64_t checksum = 0;
+    uint64_t records = 0;
+    uint64_t passes = 0;
+    uint64_t start;
+    uint64_t elapsed;
+
+    /* First pass faults the mapping in, so it is not timed */
+    if (walk_dump(dump, &records, &checksum) != 0)
+    {
+        return -1;
+    }
+
+    start = now_ns();
+    do
+    {
+        walk_dump(dump, &records, &checksum);
+        passes++;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+
+    printf("%" PRIu64 " records, %" PRIu32 " bytes, %" PRIu64 " passes\n",
+           records, dump->size, passes);
+    printf("%.1f Mrecords/s, %.1f MB/s (checksum %" PRIx64 ")\n",
+           (double)(records * passes) * 1e3 / (double)elapsed,
+           (double)dump->size * (double)passes * 1e3 / (double)elapsed,
+           checksum);
+
+    find_streams(dump, &streams);
+    if (streams.records)
+    {
+        return bench_streams(&streams);
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t iter;
+    boot_record_dump_t dump;
+    unsigned long long offset = 0;
+    unsigned long size = 0;
+    int bench = 0;
+    int status = 0;
+    int arg = 1;
+
+    if (arg < argc && strcmp(argv[arg], "-b") == 0)
+    {
+        bench = 1;
+        arg++;
+    }
+
+    if (argc - arg != 1 && argc - arg != 3)
+    {
+        fprintf(stderr, "usage: %s [-b] <file> [<offset> <size>]\n", argv[0]);
+        return 2;
+    }
+
+    if (argc - arg == 3)
+    {
+        offset = strtoull(argv[arg + 1], NULL, 0);
+        size = strtoul(argv[arg + 2], NULL, 0);
+        if (size == 0 || size > UINT32_MAX)
+        {
+            fprintf(stderr, "%s: invalid size\n", argv[arg + 2]);
+            return 2;
+        }
+    }
+
+    if (boot_record_dump_open(&dump, argv[arg], offset,
+                              (uint32_t)size) != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", argv[arg], strerror(errno));
+        return 1;
+    }
+
+    if (bench)
+    {
+        status = bench_dump(&dump);
+    }
+    else
+    {
+        boot_record_stage_iter_init(&iter, &dump);
+        while ((stage = boot_record_stage_iter_next(&iter)) != NULL)
+        {
+            print_stage(stage);
+        }
+
+        status = (iter.status == BOOT_RECORD_SUCCESS) ? 0 : -1;
+    }
+
+    boot_record_dump_close(&dump);
+
+    if (status != 0)
+    {
+        fprintf(stderr, "%s: not a valid boot record dump\n", argv[arg]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,385 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_elf.c
+ * \brief Site table reader for firmware ELF images
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_elf.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Identification bytes of the ELF header */
+#define ELF_IDENT_SIZE                      (16U)
+#define ELF_CLASS_32                        (1U)
+#define ELF_CLASS_64                        (2U)
+#define ELF_DATA_LSB                        (1U)
+#define ELF_DATA_MSB                        (2U)
+
+/* Section types and flags */
+#define ELF_SHT_NOBITS                      (8U)
+#define ELF_SHF_ALLOC                       (2U)
+
+/**
+ * Field offsets of the headers of one ELF class
+ */
+typedef struct
+{
+    /* ELF header: section header table offset, entry size, count, names */
+    uint32_t shoff;
+    uint32_t shentsize;
+    uint32_t shnum;
+    uint32_t shstrndx;
+    /* Section header: flags, address, file offset and size */
+    uint32_t sh_flags;
+    uint32_t sh_addr;
+    uint32_t sh_offset;
+    uint32_t sh_size;
+    /* Size of a section header and of an address */
+    uint32_t sh_entsize;
+    uint32_t addr_size;
+} elf_layout_t;
+
+/**
+ * Section header decoded to host types
+ */
+typedef struct
+{
+    uint32_t name;
+    uint32_t type;
+    uint64_t flags;
+    uint64_t addr;
+    uint64_t offset;
+    uint64_t size;
+} elf_section_t;
+
+/**
+ * ELF image being parsed
+ */
+typedef struct
+{
+    const uint8_t *data;
+    uint64_t size;
+    const elf_layout_t *layout;
+    int big_endian;
+    uint64_t shoff;
+    uint32_t shnum;
+} elf_image_t;
+
+/* ========================================================================== */
+/*                          Global Variables                                  */
+/* ========================================================================== */
+
+static const elf_layout_t gelf_layout_32 = {
+    32U, 46U, 48U, 50U, 8U, 12U, 16U, 20U, 40U, 4U
+};
+
+static const elf_layout_t gelf_layout_64 = {
+    40U, 58U, 60U, 62U, 8U, 16U, 24U, 32U, 64U, 8U
+};
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Read an unsigned field of 2, 4 or 8 bytes in the byte order of the image
+ */
+static uint64_t elf_read(const elf_image_t *image, uint64_t offset, uint32_t size)
+{
+    const uint8_t *p = image->data + offset;
+    uint64_t value = 0;
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        value |= (uint64_t)p[image->big_endian ? i : size - 1U - i] <<
+                 (8U * (size - 1U - i));
+    }
+
+    return value;
+}
+
+/**
+ * Decode a section header
+ *
+ * \return 0 on success, -1 if the index or the section is out of bounds
+ */
+static int elf_section(const elf_image_t *image, uint32_t index,
+                       elf_section_t *section)
+{
+    const elf_layout_t *layout = image->layout;
+    uint64_t header = image->shoff + (uint64_t)index * layout->sh_entsize;
+
+    if (index >= image->shnum)
+    {
+        return -1;
+    }
+
+    section->name = (uint32_t)elf_read(image, header, 4U);
+    section->type = (uint32_t)elf_read(image, header + 4U, 4U);
+    section->flags = elf_read(image, header + layout->sh_flags, layout->addr_size);
+    section->addr = elf_read(image, header + layout->sh_addr, layout->addr_size);
+    section->offset = elf_read(image, header + layout->sh_offset, layout->addr_size);
+    section->size = elf_read(image, header + layout->sh_size, layout->addr_size);
+
+    /* Sections without file contents only need a sane address range */
+    if (section->type == ELF_SHT_NOBITS)
+    {
+        return 0;
+    }
+
+    return (section->offset <= image->size &&
+            section->size <= image->size - section->offset) ? 0 : -1;
+}
+
+/**
+ * Find a section by name
+ *
+ * \return Index of the section, 0 if there is none
+ */
+static uint32_t elf_find_section(const elf_image_t *image, uint32_t shstrndx,
+                                 const char *name, elf_section_t *section)
+{
+    elf_section_t names;
+    size_t len = strlen(name);
+    uint32_t i;
+
+    if (elf_section(image, shstrndx, &names) != 0 ||
+        names.type == ELF_SHT_NOBITS)
+    {
+        return 0;
+    }
+
+    for (i = 1; i < image->shnum; i++)
+    {
+        if (elf_section(image, i, section) == 0 &&
+            section->name < names.size &&
+            names.size - section->name > len &&
+            memcmp(image->data + names.offset + section->name, name, len + 1U) == 0)
+        {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Resolve the address of a string to its NUL terminated contents
+ *
+ * \return String in the image, NULL if no allocated section holds all of it
+ */
+static const char *elf_string(const elf_image_t *image, uint64_t addr)
+{
+    elf_section_t section;
+    const uint8_t *start;
+    uint32_t i;
+
+    for (i = 1; i < image->shnum; i++)
+    {
+        if (elf_section(image, i, &section) != 0 ||
+            !(section.flags & ELF_SHF_ALLOC) || section.type == ELF_SHT_NOBITS ||
+            addr < section.addr || addr - section.addr >= section.size)
+        {
+            continue;
+        }
+
+        start = image->data + section.offset + (addr - section.addr);
+        if (!memchr(start, '\0', (size_t)(section.size - (addr - section.addr))))
+        {
+            return NULL;
+        }
+
+        return (const char *)start;
+    }
+
+    return NULL;
+}
+
+/**
+ * Parse the ELF header and resolve the site table
+ */
+static boot_record_status_t elf_read_sites(boot_record_elf_t *elf)
+{
+    elf_image_t image;
+    elf_section_t table;
+    boot_record_elf_site_t *site;
+    uint64_t entry;
+    uint32_t entry_size;
+    uint32_t shstrndx;
+    uint32_t i;
+
+    memset(&image, 0, sizeof(image));
+    image.data = elf->map.data;
+    image.size = elf->map.size;
+
+    if (image.size < ELF_IDENT_SIZE || memcmp(image.data, "\177ELF", 4) != 0 ||
+        (image.data[5] != ELF_DATA_LSB && image.data[5] != ELF_DATA_MSB))
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    image.big_endian = (image.data[5] == ELF_DATA_MSB);
+    if (image.data[4] == ELF_CLASS_32)
+    {
+        image.layout = &gelf_layout_32;
+    }
+    else if (image.data[4] == ELF_CLASS_64)
+    {
+        image.layout = &gelf_layout_64;
+    }
+    else
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    /* The ELF header ends after the index of the section name table */
+    if (image.size < image.layout->shstrndx + 2U)
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    image.shoff = elf_read(&image, image.layout->shoff, image.layout->addr_size);
+    image.shnum = (uint32_t)elf_read(&image, image.layout->shnum, 2U);
+    shstrndx = (uint32_t)elf_read(&image, image.layout->shstrndx, 2U);
+
+    if (elf_read(&image, image.layout->shentsize, 2U) != image.layout->sh_entsize ||
+        image.shoff > image.size ||
+        (uint64_t)image.shnum * image.layout->sh_entsize > image.size - image.shoff)
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    if (!elf_find_section(&image, shstrndx, BOOT_RECORD_SITE_SECTION, &table) ||
+        table.type == ELF_SHT_NOBITS)
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    /* Two pointers and the line, padded to the pointer alignment */
+    entry_size = 3U * image.layout->addr_size;
+    if (table.size % entry_size != 0U || table.size / entry_size > BOOT_RECORD_MAX_NAMES)
+    {
+        return BOOT_RECORD_ERR_FORMAT;
+    }
+
+    elf->count = (uint32_t)(table.size / entry_size);
+    elf->sites = calloc(elf->count + 1U, sizeof(*elf->sites));
+    if (!elf->sites)
+    {
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+
+    for (i = 0; i < elf->count; i++)
+    {
+        entry = table.offset + (uint64_t)i * entry_size;
+        site = &elf->sites[i];
+        site->name = elf_string(&image, elf_read(&image, entry, image.layout->addr_size));
+        site->file = elf_string(&image, elf_read(&image, entry + image.layout->addr_size,
+                                                 image.layout->addr_size));
+        site->line = (uint32_t)elf_read(&image, entry + 2U * image.layout->addr_size, 4U);
+
+        if (!site->name || !site->file)
+        {
+            return BOOT_RECORD_ERR_FORMAT;
+        }
+    }
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Map a linked firmware image and resolve its site table
+ */
+boot_record_status_t boot_record_elf_open(boot_record_elf_t *elf,
+                                         const char *path)
+{
+    boot_record_status_t status;
+
+    if (!elf || !path)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    memset(elf, 0, sizeof(*elf));
+
+    status = boot_record_dump_open(&elf->map, path, 0, 0);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        return status;
+    }
+
+    status = elf_read_sites(elf);
+    if (status != BOOT_RECORD_SUCCESS)
+    {
+        boot_record_elf_close(elf);
+    }
+
+    return status;
+}
+
+/**
+ * Unmap an image mapped by boot_record_elf_open
+ */
+void boot_record_elf_close(boot_record_elf_t *elf)
+{
+    if (elf)
+    {
+        free(elf->sites);
+        boot_record_dump_close(&elf->map);
+        memset(elf, 0, sizeof(*elf));
+    }
+}
+
+/**
+ * Look up a site ID in the site table of an image
+ */
+const boot_record_elf_site_t *boot_record_elf_site(const boot_record_elf_t *elf,
+                                                   uint32_t site_id)
+{
+    if (!elf || site_id >= elf->count)
+    {
+        return NULL;
+    }
+
+    return &elf->sites[site_id];
+}
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_elf.h
+ * \brief Site table reader for firmware ELF images
+ *
+ * Reads the entries BOOT_RECORD_SITE_DEFINE placed in BOOT_RECORD_SITE_SECTION
+ * of a linked image, so that stages logged with BOOT_RECORD_FLAG_SITE_IDS
+ * can be printed with full names and call sites. ELF32 and ELF64 images of
+ * either byte order are supported, independent of the host.
+ */
+
+#ifndef BOOT_RECORD_ELF_H
+#define BOOT_RECORD_ELF_H
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stdint.h>
+
+#include "bootrecord_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Site table entry resolved from an image
+ */
+typedef struct
+{
+    /* Name of the profile point, NUL terminated in the mapped image */
+    const char *name;
+    /* Source file of the call site, NUL terminated in the mapped image */
+    const char *file;
+    /* Source line of the call site */
+    uint32_t line;
+} boot_record_elf_site_t;
+
+/**
+ * Firmware image mapped into memory, with its site table
+ */
+typedef struct
+{
+    /* Mapping of the whole ELF file */
+    boot_record_dump_t map;
+    /* Entries in site ID order */
+    boot_record_elf_site_t *sites;
+    /* Number of entries */
+    uint32_t count;
+} boot_record_elf_t;
+
+/* ========================================================================== */
+/*                          Function Declarations                             */
+/* ========================================================================== */
+
+/**
+ * Map a linked firmware image and resolve its site table
+ *
+ * The names and files stay in the mapping, nothing is copied. The image
+ * must be linked to its final addresses, as the pointers of the entries are
+ * looked up in its allocated sections.
+ *
+ * \param elf Image to initialize
+ * \param path ELF file
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_INVALID_PARAMS
+ *         if the file can't be opened or mapped, with errno telling why,
+ *         BOOT_RECORD_ERR_FORMAT if it is not an ELF image with a valid site
+ *         table, BOOT_RECORD_ERR_INSUFFICIENT_MEM if out of memory
+ */
+boot_record_status_t boot_record_elf_open(boot_record_elf_t *elf,
+                                         const char *path);
+
+/**
+ * Unmap an image mapped by boot_record_elf_open
+ *
+ * \param elf Image to release
+ */
+void boot_record_elf_close(boot_record_elf_t *elf);
+
+/**
+ * Look up a site ID in the site table of an image
+ *
+ * \param elf Image opened by boot_record_elf_open
+ * \param site_id Name ID of a record of a BOOT_RECORD_FLAG_SITE_IDS stage
+ * \return Entry, NULL if the ID is out of range
+ */
+const boot_record_elf_site_t *boot_record_elf_site(const boot_record_elf_t *elf,
+                                                   uint32_t site_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RECORD_ELF_H */
@@ -0,0 +1,449 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_ingest.c
+ * \brief Parallel aggregation of large sets of boot record dump files
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_ingest.h"
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Files are handed out as [first, end) index ranges packed in 64 bits, so a
+ * single compare-and-swap takes files from either end */
+#define RANGE_PACK(first, end)  (((uint64_t)(end) << 32) | (uint64_t)(first))
+#define RANGE_FIRST(range)      ((uint32_t)(range))
+#define RANGE_END(range)        ((uint32_t)((range) >> 32))
+
+/* Size of a cache line, keeping the ranges of two threads apart */
+#define CACHE_LINE_SIZE         (64U)
+
+typedef struct ingest_pool ingest_pool_t;
+
+/**
+ * Ingestion thread
+ */
+typedef struct
+{
+    /* Files left to this thread, taken from the front by the thread itself
+     * and from the back by thieves */
+    uint64_t range __attribute__((aligned(CACHE_LINE_SIZE)));
+    /* Private aggregate, the caller's aggregate for thread 0 */
+    boot_record_agg_t *agg;
+    boot_record_agg_t own_agg;
+    /* Pool of the thread and its index in it */
+    ingest_pool_t *pool;
+    uint32_t index;
+    /* Whether the thread was started */
+    int started;
+    pthread_t thread;
+    /* Files added and failed, and bytes mapped by this thread */
+    uint32_t files;
+    uint32_t failed;
+    uint64_t bytes;
+} ingest_worker_t;
+
+/**
+ * Shared state of an ingestion
+ */
+struct ingest_pool
+{
+    char *const *paths;
+    const boot_record_ingest_params_t *params;
+    ingest_worker_t *workers;
+    uint32_t worker_count;
+};
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Initialize an empty path list
+ */
+void boot_record_path_list_init(boot_record_path_list_t *list)
+{
+    memset(list, 0, sizeof(*list));
+}
+
+/**
+ * Append a copy of a path to a path list
+ */
+static boot_record_status_t boot_record_path_list_push(boot_record_path_list_t *list,
+                                                       const char *path)
+{
+    char **paths;
+    uint32_t capacity;
+
+    if (list->count == list->capacity)
+    {
+        capacity = list->capacity ? 2U * list->capacity : 256U;
+        paths = realloc(list->paths, capacity * sizeof(*paths));
+        if (!paths)
+        {
+            return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+        }
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+
+    list->paths[list->count] = strdup(path);
+    if (!list->paths[list->count])
+    {
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+    list->count++;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Add a dump file, or every regular file under a directory, to a path list
+ */
+boot_record_status_t boot_record_path_list_add(boot_record_path_list_t *list,
+                                               const char *path)
+{
+    boot_record_status_t status = BOOT_RECORD_SUCCESS;
+    struct dirent *entry;
+    struct stat st;
+    size_t length;
+    char *child;
+    DIR *dir;
+
+    if (stat(path, &st) != 0)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    if (!S_ISDIR(st.st_mode))
+    {
+        return boot_record_path_list_push(list, path);
+    }
+
+    dir = opendir(path);
+    if (!dir)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    while (status == BOOT_RECORD_SUCCESS && (entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        length = strlen(path) + strlen(entry->d_name) + 2U;
+        child = malloc(length);
+        if (!child)
+        {
+            status = BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+            break;
+        }
+        snprintf(child, length, "%s/%s", path, entry->d_name);
+
+        if (stat(child, &st) != 0)
+        {
+            /* Removed since the directory was read */
+        }
+        else if (S_ISDIR(st.st_mode))
+        {
+            status = boot_record_path_list_add(list, child);
+        }
+        else if (S_ISREG(st.st_mode))
+        {
+            status = boot_record_path_list_push(list, child);
+        }
+        free(child);
+    }
+
+    closedir(dir);
+
+    return status;
+}
+
+/**
+ * Free the paths of a path list
+ */
+void boot_record_path_list_free(boot_record_path_list_t *list)
+{
+    uint32_t i;
+
+    for (i = 0; i < list->count; i++)
+    {
+        free(list->paths[i]);
+    }
+    free(list->paths);
+    memset(list, 0, sizeof(*list));
+}
+
+/**
+ * Take the next file of a thread's own range
+ *
+ * \return 1 with the file index in index, 0 if the range is empty
+ */
+static int ingest_take(ingest_worker_t *worker, uint32_t *index)
+{
+    uint64_t range = __atomic_load_n(&worker->range, __ATOMIC_ACQUIRE);
+
+    while (RANGE_FIRST(range) < RANGE_END(range))
+    {
+        if (__atomic_compare_exchange_n(&worker->range, &range,
+                                        RANGE_PACK(RANGE_FIRST(range) + 1U,
+                                                   RANGE_END(range)),
+                                        0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            *index = RANGE_FIRST(range);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Steal the back half of another thread's files into an empty range
+ *
+ * Nothing adds files once ingestion started, so when every other range is
+ * found empty the thread can stop: the files taken by the others are theirs
+ * to finish.
+ *
+ * \return 1 with the first stolen file index in index, 0 if no file is left
+ */
+static int ingest_steal(ingest_worker_t *worker, uint32_t *index)
+{
+    ingest_pool_t *pool = worker->pool;
+    ingest_worker_t *victim;
+    uint64_t range;
+    uint32_t first;
+    uint32_t end;
+    uint32_t i;
+
+    for (i = 1; i < pool->worker_count; i++)
+    {
+        victim = &pool->workers[(worker->index + i) % pool->worker_count];
+        range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+        while (RANGE_FIRST(range) < RANGE_END(range))
+        {
+            end = RANGE_END(range);
+            first = end - (end - RANGE_FIRST(range) + 1U) / 2U;
+
+            if (__atomic_compare_exchange_n(&victim->range, &range,
+                                            RANGE_PACK(RANGE_FIRST(range), first),
+                                            0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                __atomic_store_n(&worker->range, RANGE_PACK(first + 1U, end),
+                                 __ATOMIC_RELEASE);
+                *index = first;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Map one dump file and add it to a thread's aggregate
+ */
+static void ingest_file(ingest_worker_t *worker, const char *path)
+{
+    const boot_record_ingest_params_t *params = worker->pool->params;
+    boot_record_status_t status;
+    boot_record_dump_t dump;
+
+    status = boot_record_dump_open(&dump, path, 0, 0);
+    if (status == BOOT_RECORD_SUCCESS)
+    {
+        worker->bytes += dump.size;
+        status = boot_record_agg_add_dump(worker->agg, &dump);
+        boot_record_dump_close(&dump);
+        /* An invalid dump has no errno */
+        errno = 0;
+    }
+
+    if (status == BOOT_RECORD_SUCCESS)
+    {
+        worker->files++;
+    }
+    else
+    {
+        worker->failed++;
+        if (params && params->error_fn)
+        {
+            params->error_fn(path, status, errno, params->error_arg);
+        }
+    }
+}
+
+/**
+ * Ingestion thread body
+ */
+static void *ingest_run(void *arg)
+{
+    ingest_worker_t *worker = arg;
+    uint32_t index;
+
+    while (ingest_take(worker, &index) || ingest_steal(worker, &index))
+    {
+        ingest_file(worker, worker->pool->paths[index]);
+    }
+
+    return NULL;
+}
+
+/**
+ * Add a set of dump files to an aggregate on a pool of threads
+ */
+boot_record_status_t boot_record_ingest(boot_record_agg_t *agg,
+                                        char *const *paths, uint32_t count,
+                                        const boot_record_ingest_params_t *params,
+                                        boot_record_ingest_result_t *result)
+{
+    boot_record_status_t status = BOOT_RECORD_SUCCESS;
+    ingest_worker_t *worker;
+    ingest_pool_t pool;
+    long online;
+    uint32_t i;
+
+    if (!agg || (!paths && count))
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    pool.paths = paths;
+    pool.params = params;
+    pool.worker_count = params ? params->threads : 0U;
+    if (pool.worker_count == 0U)
+    {
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+        pool.worker_count = (online > 0) ? (uint32_t)online : 1U;
+    }
+    if (pool.worker_count > count && count)
+    {
+        pool.worker_count = count;
+    }
+
+    if (posix_memalign((void **)&pool.workers, CACHE_LINE_SIZE,
+                       pool.worker_count * sizeof(*pool.workers)) != 0)
+    {
+        return BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+    }
+    memset(pool.workers, 0, pool.worker_count * sizeof(*pool.workers));
+
+    /* Every thread starts with an equal share, stealing evens out the rest */
+    for (i = 0; i < pool.worker_count; i++)
+    {
+        worker = &pool.workers[i];
+        worker->range = RANGE_PACK((uint64_t)count * i / pool.worker_count,
+                                   (uint64_t)count * (i + 1U) / pool.worker_count);
+        worker->pool = &pool;
+        worker->index = i;
+        worker->agg = &worker->own_agg;
+
+        if (i == 0)
+        {
+            worker->agg = agg;
+        }
+        else if (boot_record_agg_init(&worker->own_agg, agg->max_pairs) != BOOT_RECORD_SUCCESS)
+        {
+            status = BOOT_RECORD_ERR_INSUFFICIENT_MEM;
+            pool.worker_count = i;
+            break;
+        }
+    }
+
+    if (status == BOOT_RECORD_SUCCESS)
+    {
+        /* A thread that fails to start leaves its files to be stolen */
+        for (i = 1; i < pool.worker_count; i++)
+        {
+            worker = &pool.workers[i];
+            worker->started = (pthread_create(&worker->thread, NULL, ingest_run,
+                                              worker) == 0);
+        }
+
+        ingest_run(&pool.workers[0]);
+    }
+
+    if (result)
+    {
+        memset(result, 0, sizeof(*result));
+        result->threads = 1U;
+    }
+
+    for (i = 0; i < pool.worker_count; i++)
+    {
+        worker = &pool.workers[i];
+        if (worker->started)
+        {
+            pthread_join(worker->thread, NULL);
+            if (result)
+            {
+                result->threads++;
+            }
+        }
+
+        if (i > 0)
+        {
+            boot_record_agg_merge(agg, &worker->own_agg);
+            boot_record_agg_free(&worker->own_agg);
+        }
+
+        if (result)
+        {
+            result->files += worker->files;
+            result->failed += worker->failed;
+            result->bytes += worker->bytes;
+        }
+    }
+
+    free(pool.workers);
+
+    return status;
+}
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_ingest.h
+ * \brief Parallel aggregation of large sets of boot record dump files
+ *
+ * The files are split over a pool of threads. Each thread maps its files
+ * with the reader, validates and decodes them in place, and adds them to a
+ * private aggregate. A thread that runs out of files steals half of the
+ * remaining files of another one, so a few large dumps don't leave the
+ * other threads idle. The private aggregates are merged at the end.
+ */
+
+#ifndef BOOT_RECORD_INGEST_H
+#define BOOT_RECORD_INGEST_H
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stdint.h>
+
+#include "bootrecord_agg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Growable list of dump file paths
+ */
+typedef struct
+{
+    /* Paths, owned by the list */
+    char **paths;
+    /* Number of paths and allocated entries */
+    uint32_t count;
+    uint32_t capacity;
+} boot_record_path_list_t;
+
+/**
+ * Callback receiving a file that could not be added, called from the
+ * ingestion threads
+ */
+typedef void (*boot_record_ingest_error_fn)(const char *path,
+                                            boot_record_status_t status,
+                                            int error, void *arg);
+
+/**
+ * Ingestion parameters
+ */
+typedef struct
+{
+    /* Number of threads, 0 for one per online CPU */
+    uint32_t threads;
+    /* Optional callback for files that could not be added */
+    boot_record_ingest_error_fn error_fn;
+    /* Opaque argument passed to error_fn */
+    void *error_arg;
+} boot_record_ingest_params_t;
+
+/**
+ * Ingestion summary
+ */
+typedef struct
+{
+    /* Number of threads used */
+    uint32_t threads;
+    /* Number of valid dumps added */
+    uint32_t files;
+    /* Number of files that could not be mapped or hold an invalid stage;
+     * the stages before an invalid one are still added */
+    uint32_t failed;
+    /* Total size of the files mapped */
+    uint64_t bytes;
+} boot_record_ingest_result_t;
+
+/* ========================================================================== */
+/*                          Function Declarations                             */
+/* ========================================================================== */
+
+/**
+ * Initialize an empty path list
+ *
+ * \param list List to initialize
+ */
+void boot_record_path_list_init(boot_record_path_list_t *list);
+
+/**
+ * Add a dump file, or every regular file under a directory, to a path list
+ *
+ * \param list List to add to
+ * \param path File or directory; directories are walked recursively and
+ *        entries starting with '.' are skipped
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_INVALID_PARAMS with
+ *         errno set if path or a directory under it can't be read,
+ *         BOOT_RECORD_ERR_INSUFFICIENT_MEM if the list can't grow
+ */
+boot_record_status_t boot_record_path_list_add(boot_record_path_list_t *list,
+                                               const char *path);
+
+/**
+ * Free the paths of a path list
+ *
+ * \param list List initialized by boot_record_path_list_init
+ */
+void boot_record_path_list_free(boot_record_path_list_t *list);
+
+/**
+ * Add a set of dump files to an aggregate on a pool of threads
+ *
+ * \param agg Aggregate to add to; the private aggregate of every thread has
+ *        the same max_pairs
+ * \param paths Dump files
+ * \param count Number of dump files
+ * \param params Ingestion parameters, NULL for the defaults
+ * \param result Optional pointer to receive the ingestion summary
+ * \return BOOT_RECORD_SUCCESS once every file was tried, error code if the
+ *         private aggregates can't be allocated; failed files are only
+ *         counted and reported to error_fn
+ */
+boot_record_status_t boot_record_ingest(boot_record_agg_t *agg,
+                                        char *const *paths, uint32_t count,
+                                        const boot_record_ingest_params_t *params,
+                                        boot_record_ingest_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RECORD_INGEST_H */
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_merge.c
+ * \brief Host tool printing a boot record dump as one time-ordered timeline
+ *
+ * Usage: bootrecord_merge <dump.bin>
+ *
+ * The dump holds either a single boot stage or a boot record chain, whose
+ * stages are printed one after another. Records of per-CPU stages are merged
+ * across CPUs and printed with the CPU that logged them, along with their
+ * offset from the stage start in microseconds. Span records are indented by
+ * their nesting depth.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_reader.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Context of the merge callback
+ */
+typedef struct
+{
+    const boot_stage_record_t *stage;
+    boot_record_tconv_t to_us;
+} merge_ctx_t;
+
+static void print_event(const boot_record_event_t *event, void *arg)
+{
+    const merge_ctx_t *ctx = arg;
+    uint64_t start = ctx->stage->start_time;
+    const char *wait_name;
+    uint64_t offset_us;
+
+    offset_us = boot_record_tconv_apply(&ctx->to_us, event->time >= start ?
+                                                     event->time - start :
+                                                     start - event->time);
+
+    printf("%20" PRIu64 " %c%11" PRIu64 "  cpu%-2" PRIu32 "  %*s%s",
+           event->time, event->time >= start ? '+' : '-', offset_us,
+           event->cpu_id, (int)(2U * event->depth), "",
+           event->kind == BOOT_RECORD_KIND_BEGIN ? "begin " :
+           event->kind == BOOT_RECORD_KIND_END ? "end " : "");
+
+    if (event->name)
+    {
+        printf("%.*s", (int)BOOT_RECORD_NAME_LEN - 1, event->name);
+    }
+    else
+    {
+        printf("#%" PRIu32, event->name_id);
+    }
+
+    if (event->kind == BOOT_RECORD_KIND_WAIT)
+    {
+        wait_name = boot_record_get_name(ctx->stage, event->wait_id);
+        if (wait_name)
+        {
+            printf(" (waited for %.*s)", (int)BOOT_RECORD_NAME_LEN - 1, wait_name);
+        }
+        else
+        {
+            printf(" (waited for #%" PRIu32 ")", event->wait_id);
+        }
+    }
+
+    printf("\n");
+}
+
+/**
+ * Print the merged timeline of one validated boot stage
+ */
+static void print_stage(const boot_stage_record_t *stage)
+{
+    merge_ctx_t ctx;
+
+    ctx.stage = stage;
+    boot_record_tconv_init(&ctx.to_us, stage, BOOT_RECORD_UNIT_US);
+
+    printf("stage %" PRIu32 ", start %" PRIu64 ", %s\n", stage->record_id,
+           stage->start_time,
+           stage->time_unit == BOOT_RECORD_TIME_TICKS ? "ticks" : "us");
+    if (stage->flags & BOOT_RECORD_FLAG_RING)
+    {
+        uint64_t lost = stage->lost_count;
+        uint32_t cpu;
+
+        for (cpu = 0; cpu < stage->cpu_count; cpu++)
+        {
+            lost += boot_record_get_cpu_stage(stage, cpu)->lost_count;
+        }
+
+        printf("%" PRIu64 " oldest records overwritten\n", lost);
+    }
+
+    boot_record_merge(stage, print_event, &ctx);
+}
+
+int main(int argc, char **argv)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t iter;
+    boot_record_dump_t dump;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <dump.bin>\n", argv[0]);
+        return 2;
+    }
+
+    if (boot_record_dump_open(&dump, argv[1], 0, 0) != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+
+    boot_record_stage_iter_init(&iter, &dump);
+    while ((stage = boot_record_stage_iter_next(&iter)) != NULL)
+    {
+        if (iter.next > 1U)
+        {
+            printf("\n");
+        }
+        print_stage(stage);
+    }
+
+    boot_record_dump_close(&dump);
+
+    if (iter.status != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: not a valid boot record dump\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,563 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_perfetto.c
+ * \brief Host tool exporting boot record dumps as a Perfetto protobuf trace
+ *
+ * Usage: bootrecord_perfetto [-b] <dump.bin>... > trace.perfetto-trace
+ *
+ * Writes the same tracks and events as bootrecord_trace, as TracePacket
+ * messages instead of JSON. Every stage is its own packet sequence. Event
+ * names are interned once per sequence and timestamps are written as
+ * deltas on an incremental clock, so most event packets take a few bytes.
+ * Packets are written as the records are merged, so memory use does not
+ * depend on the size of the dumps.
+ *
+ * The protobuf encoding is written by hand for the handful of fields used,
+ * so no protobuf library is needed.
+ *
+ * With -b the trace goes to a temporary file, and the tool prints its size
+ * and how long it took to write, for comparison with bootrecord_trace -b.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_reader.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Protobuf wire types */
+#define PB_VARINT                           (0U)
+#define PB_LEN                              (2U)
+
+/* Largest message built in memory, longer strings are truncated */
+#define PB_MAX_MSG                          (512U)
+#define PB_MAX_STRING                       (256U)
+
+/* Field numbers of the Perfetto trace protos */
+#define TRACE_PACKET                        (1U)
+#define PACKET_CLOCK_SNAPSHOT               (6U)
+#define PACKET_TIMESTAMP                    (8U)
+#define PACKET_SEQUENCE_ID                  (10U)
+#define PACKET_TRACK_EVENT                  (11U)
+#define PACKET_INTERNED_DATA                (12U)
+#define PACKET_SEQUENCE_FLAGS               (13U)
+#define PACKET_TIMESTAMP_CLOCK_ID           (58U)
+#define PACKET_DEFAULTS                     (59U)
+#define PACKET_TRACK_DESCRIPTOR             (60U)
+#define CLOCK_SNAPSHOT_CLOCKS               (1U)
+#define CLOCK_ID                            (1U)
+#define CLOCK_TIMESTAMP                     (2U)
+#define CLOCK_IS_INCREMENTAL                (3U)
+#define DEFAULTS_TIMESTAMP_CLOCK_ID         (58U)
+#define TRACK_UUID                          (1U)
+#define TRACK_NAME                          (2U)
+#define TRACK_PROCESS                       (3U)
+#define TRACK_PARENT_UUID                   (5U)
+#define PROCESS_PID                         (1U)
+#define PROCESS_NAME                        (6U)
+#define EVENT_TYPE                          (9U)
+#define EVENT_NAME_IID                      (10U)
+#define EVENT_TRACK_UUID                    (11U)
+#define EVENT_NAME                          (23U)
+#define INTERNED_EVENT_NAMES                (2U)
+#define EVENT_NAME_ENTRY_IID                (1U)
+#define EVENT_NAME_ENTRY_NAME               (2U)
+
+/* TrackEvent types */
+#define EVENT_TYPE_SLICE_BEGIN              (1U)
+#define EVENT_TYPE_SLICE_END                (2U)
+#define EVENT_TYPE_INSTANT                  (3U)
+
+/* TracePacket sequence flags */
+#define SEQ_INCREMENTAL_STATE_CLEARED       (1U)
+#define SEQ_NEEDS_INCREMENTAL_STATE         (2U)
+
+/* Built-in BOOTTIME clock, and the sequence-scoped clock carrying deltas */
+#define TRACE_CLOCK_BOOTTIME                (6U)
+#define TRACE_CLOCK_DELTA                   (64U)
+
+/* Slots of the inline name interning table, a power of two */
+#define NAME_TABLE_SIZE                     (4096U)
+
+/**
+ * Protobuf message being built
+ */
+typedef struct
+{
+    uint8_t data[PB_MAX_MSG];
+    uint32_t len;
+} pb_msg_t;
+
+/**
+ * Interned inline name
+ */
+typedef struct
+{
+    char name[BOOT_RECORD_NAME_LEN];
+    /* Interning ID, 0 for a free slot */
+    uint32_t iid;
+} name_slot_t;
+
+/**
+ * Output state of the packet sequence of one stage
+ */
+typedef struct
+{
+    FILE *out;
+    const boot_stage_record_t *stage;
+    boot_record_tconv_t to_ns;
+    uint32_t sequence_id;
+    /* UUID of the track of the stage's first CPU */
+    uint64_t track_uuid;
+    /* Value of the delta clock after the last event */
+    uint64_t last_ns;
+    /* Interning ID to give to the next new inline name */
+    uint32_t next_iid;
+    /* Inline names interned so far */
+    uint32_t name_count;
+    /* Name IDs already interned, for stages using name IDs */
+    uint8_t id_seen[(BOOT_RECORD_MAX_NAMES + 8U) / 8U];
+    name_slot_t names[NAME_TABLE_SIZE];
+} sequence_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+static void pb_varint(pb_msg_t *msg, uint64_t value)
+{
+    do
+    {
+        if (msg->len < PB_MAX_MSG)
+        {
+            msg->data[msg->len++] = (uint8_t)((value & 0x7FU) |
+                                              (value > 0x7FU ? 0x80U : 0U));
+        }
+        value >>= 7;
+    } while (value);
+}
+
+static void pb_uint(pb_msg_t *msg, uint32_t field, uint64_t value)
+{
+    pb_varint(msg, ((uint64_t)field << 3) | PB_VARINT);
+    pb_varint(msg, value);
+}
+
+static void pb_bytes(pb_msg_t *msg, uint32_t field, const void *data,
+                     uint32_t len)
+{
+    pb_varint(msg, ((uint64_t)field << 3) | PB_LEN);
+    pb_varint(msg, len);
+    if (len <= PB_MAX_MSG - msg->len)
+    {
+        memcpy(&msg->data[msg->len], data, len);
+        msg->len += len;
+    }
+}
+
+static void pb_string(pb_msg_t *msg, uint32_t field, const char *s,
+                      uint32_t max_len)
+{
+    pb_bytes(msg, field, s, (uint32_t)strnlen(s, max_len));
+}
+
+static void pb_msg(pb_msg_t *msg, uint32_t field, const pb_msg_t *sub)
+{
+    pb_bytes(msg, field, sub->data, sub->len);
+}
+
+/**
+ * Write a finished TracePacket to the output
+ */
+static void write_packet(FILE *out, const pb_msg_t *packet)
+{
+    pb_msg_t prefix;
+
+    prefix.len = 0;
+    pb_varint(&prefix, ((uint64_t)TRACE_PACKET << 3) | PB_LEN);
+    pb_varint(&prefix, packet->len);
+    fwrite(prefix.data, 1, prefix.len, out);
+    fwrite(packet->data, 1, packet->len, out);
+}
+
+/**
+ * Start a sequence: clear its state and set up the delta clock
+ */
+static void write_sequence_start(sequence_t *seq)
+{
+    pb_msg_t packet = { .len = 0 };
+    pb_msg_t snapshot = { .len = 0 };
+    pb_msg_t clock = { .len = 0 };
+    pb_msg_t defaults = { .len = 0 };
+
+    /* The delta clock starts at 0, which is 0 on the BOOTTIME clock */
+    pb_uint(&clock, CLOCK_ID, TRACE_CLOCK_DELTA);
+    pb_uint(&clock, CLOCK_TIMESTAMP, 0);
+    pb_uint(&clock, CLOCK_IS_INCREMENTAL, 1);
+    pb_msg(&snapshot, CLOCK_SNAPSHOT_CLOCKS, &clock);
+    clock.len = 0;
+    pb_uint(&clock, CLOCK_ID, TRACE_CLOCK_BOOTTIME);
+    pb_uint(&clock, CLOCK_TIMESTAMP, 0);
+    pb_msg(&snapshot, CLOCK_SNAPSHOT_CLOCKS, &clock);
+
+    pb_uint(&defaults, DEFAULTS_TIMESTAMP_CLOCK_ID, TRACE_CLOCK_DELTA);
+
+    pb_uint(&packet, PACKET_TIMESTAMP, 0);
+    pb_uint(&packet, PACKET_TIMESTAMP_CLOCK_ID, TRACE_CLOCK_BOOTTIME);
+    pb_uint(&packet, PACKET_SEQUENCE_ID, seq->sequence_id);
+    pb_uint(&packet, PACKET_SEQUENCE_FLAGS, SEQ_INCREMENTAL_STATE_CLEARED);
+    pb_msg(&packet, PACKET_CLOCK_SNAPSHOT, &snapshot);
+    pb_msg(&packet, PACKET_DEFAULTS, &defaults);
+    write_packet(seq->out, &packet);
+}
+
+/**
+ * Describe a track, a process track when pid is non-zero
+ */
+static void write_track(const sequence_t *seq, uint64_t uuid,
+                        uint64_t parent_uuid, uint32_t pid, const char *name)
+{
+    pb_msg_t packet = { .len = 0 };
+    pb_msg_t track = { .len = 0 };
+    pb_msg_t process = { .len = 0 };
+
+    pb_uint(&track, TRACK_UUID, uuid);
+    if (pid)
+    {
+        pb_uint(&process, PROCESS_PID, pid);
+        pb_string(&process, PROCESS_NAME, name, PB_MAX_STRING);
+        pb_msg(&track, TRACK_PROCESS, &process);
+    }
+    else
+    {
+        pb_string(&track, TRACK_NAME, name, PB_MAX_STRING);
+        pb_uint(&track, TRACK_PARENT_UUID, parent_uuid);
+    }
+
+    pb_uint(&packet, PACKET_SEQUENCE_ID, seq->sequence_id);
+    pb_msg(&packet, PACKET_TRACK_DESCRIPTOR, &track);
+    write_packet(seq->out, &packet);
+}
+
+/**
+ * Find the interning ID of a name, adding it to the interned data if new
+ *
+ * \return Interning ID, 0 if the name is written inline instead
+ */
+static uint32_t intern_name(sequence_t *seq, const boot_record_event_t *event,
+                            pb_msg_t *interned)
+{
+    pb_msg_t entry = { .len = 0 };
+    uint32_t hash = 2166136261U;
+    uint32_t iid;
+    uint32_t i;
+
+    if (!event->name)
+    {
+        return 0;
+    }
+
+    if (event->name_id != BOOT_RECORD_NAME_ID_NONE)
+    {
+        /* The stage's name table already numbers its names */
+        iid = event->name_id + 1U;
+        if (seq->id_seen[event->name_id / 8U] & (1U << (event->name_id % 8U)))
+        {
+            return iid;
+        }
+        seq->id_seen[event->name_id / 8U] |= (uint8_t)(1U << (event->name_id % 8U));
+    }
+    else
+    {
+        for (i = 0; i < BOOT_RECORD_NAME_LEN - 1U && event->name[i]; i++)
+        {
+            hash = (hash ^ (uint8_t)event->name[i]) * 16777619U;
+        }
+
+        for (i = hash & (NAME_TABLE_SIZE - 1U); seq->names[i].iid;
+             i = (i + 1U) & (NAME_TABLE_SIZE - 1U))
+        {
+            if (strncmp(seq->names[i].name, event->name,
+                        BOOT_RECORD_NAME_LEN - 1U) == 0)
+            {
+                return seq->names[i].iid;
+            }
+        }
+
+        /* Keep the table at most half full, later new names go inline */
+        if (seq->name_count >= NAME_TABLE_SIZE / 2U)
+        {
+            return 0;
+        }
+
+        iid = seq->next_iid++;
+        seq->name_count++;
+        strncpy(seq->names[i].name, event->name, BOOT_RECORD_NAME_LEN - 1U);
+        seq->names[i].iid = iid;
+    }
+
+    pb_uint(&entry, EVENT_NAME_ENTRY_IID, iid);
+    pb_string(&entry, EVENT_NAME_ENTRY_NAME, event->name,
+              BOOT_RECORD_NAME_LEN - 1U);
+    pb_msg(interned, INTERNED_EVENT_NAMES, &entry);
+
+    return iid;
+}
+
+/**
+ * Write one record as a TrackEvent packet, called in time order
+ */
+static void write_event(const boot_record_event_t *event, void *arg)
+{
+    sequence_t *seq = arg;
+    pb_msg_t packet = { .len = 0 };
+    pb_msg_t track_event = { .len = 0 };
+    pb_msg_t interned = { .len = 0 };
+    uint64_t ns = boot_record_tconv_apply(&seq->to_ns, event->time);
+    char id_name[16];
+    uint32_t iid;
+
+    /* An end record whose begin record was overwritten in ring mode */
+    if (event->kind == BOOT_RECORD_KIND_END &&
+        event->link == BOOT_RECORD_INDEX_NONE)
+    {
+        return;
+    }
+
+    pb_uint(&track_event, EVENT_TYPE,
+            event->kind == BOOT_RECORD_KIND_BEGIN ? EVENT_TYPE_SLICE_BEGIN :
+            event->kind == BOOT_RECORD_KIND_END ? EVENT_TYPE_SLICE_END :
+            EVENT_TYPE_INSTANT);
+    pb_uint(&track_event, EVENT_TRACK_UUID, seq->track_uuid + event->cpu_id);
+
+    if (event->kind != BOOT_RECORD_KIND_END)
+    {
+        iid = intern_name(seq, event, &interned);
+        if (iid)
+        {
+            pb_uint(&track_event, EVENT_NAME_IID, iid);
+        }
+        else if (event->name)
+        {
+            pb_string(&track_event, EVENT_NAME, event->name,
+                      BOOT_RECORD_NAME_LEN - 1U);
+        }
+        else
+        {
+            snprintf(id_name, sizeof(id_name), "#%" PRIu32, event->name_id);
+            pb_string(&track_event, EVENT_NAME, id_name, sizeof(id_name));
+        }
+    }
+
+    /* Deltas can't be negative, a clock going back is written in full */
+    if (ns >= seq->last_ns)
+    {
+        pb_uint(&packet, PACKET_TIMESTAMP, ns - seq->last_ns);
+        seq->last_ns = ns;
+    }
+    else
+    {
+        pb_uint(&packet, PACKET_TIMESTAMP, ns);
+        pb_uint(&packet, PACKET_TIMESTAMP_CLOCK_ID, TRACE_CLOCK_BOOTTIME);
+    }
+
+    pb_uint(&packet, PACKET_SEQUENCE_ID, seq->sequence_id);
+    pb_uint(&packet, PACKET_SEQUENCE_FLAGS, SEQ_NEEDS_INCREMENTAL_STATE);
+    pb_msg(&packet, PACKET_TRACK_EVENT, &track_event);
+    if (interned.len)
+    {
+        pb_msg(&packet, PACKET_INTERNED_DATA, &interned);
+    }
+    write_packet(seq->out, &packet);
+}
+
+/**
+ * Write the tracks and events of one validated boot stage as a sequence
+ *
+ * \param pid Number of the stage's dump
+ * \param path Path of the dump, to describe its process track in the
+ *        dump's first sequence; NULL for later sequences
+ * \param stage_index Position of the stage in its dump
+ */
+static void write_stage(sequence_t *seq, uint32_t pid, const char *path,
+                        uint32_t stage_index, const boot_stage_record_t *stage)
+{
+    uint64_t process_uuid = (uint64_t)pid << 32;
+    uint32_t tracks = (stage->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+                      stage->cpu_count : 1U;
+    uint32_t cpu;
+    char name[48];
+
+    seq->stage = stage;
+    seq->track_uuid = process_uuid + stage_index * BOOT_RECORD_MAX_CPUS + 1U;
+    seq->last_ns = 0;
+    seq->next_iid = 1U;
+    seq->name_count = 0;
+    memset(seq->id_seen, 0, sizeof(seq->id_seen));
+    memset(seq->names, 0, sizeof(seq->names));
+    boot_record_tconv_init(&seq->to_ns, stage, BOOT_RECORD_UNIT_NS);
+
+    write_sequence_start(seq);
+
+    if (path)
+    {
+        write_track(seq, process_uuid, 0, pid, path);
+    }
+
+    for (cpu = 0; cpu < tracks; cpu++)
+    {
+        if (stage->flags & BOOT_RECORD_FLAG_PER_CPU)
+        {
+            snprintf(name, sizeof(name), "stage %" PRIu32 " cpu%" PRIu32,
+                     stage->record_id, cpu);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "stage %" PRIu32, stage->record_id);
+        }
+        write_track(seq, seq->track_uuid + cpu, process_uuid, 0, name);
+    }
+
+    boot_record_merge(stage, write_event, seq);
+}
+
+/**
+ * Write every stage of one dump file under a process track
+ *
+ * \return 0 on success, -1 if the dump can't be read or is invalid
+ */
+static int write_dump(sequence_t *seq, uint32_t pid, const char *path)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t iter;
+    boot_record_dump_t dump;
+    uint32_t stage_index = 0;
+
+    if (boot_record_dump_open(&dump, path, 0, 0) != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    boot_record_stage_iter_init(&iter, &dump);
+    while ((stage = boot_record_stage_iter_next(&iter)) != NULL)
+    {
+        seq->sequence_id++;
+        write_stage(seq, pid, stage_index ? NULL : path, stage_index, stage);
+        stage_index++;
+    }
+
+    boot_record_dump_close(&dump);
+
+    if (iter.status != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: not a valid boot record dump\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    static sequence_t seq;
+    uint64_t elapsed;
+    int bench = 0;
+    int status = 0;
+    int first = 1;
+    int i;
+
+    if (argc > 1 && strcmp(argv[1], "-b") == 0)
+    {
+        bench = 1;
+        first = 2;
+    }
+
+    if (argc <= first)
+    {
+        fprintf(stderr, "usage: %s [-b] <dump.bin>... > trace.perfetto-trace\n",
+                argv[0]);
+        return 2;
+    }
+
+    seq.out = bench ? tmpfile() : stdout;
+    if (!seq.out)
+    {
+        perror("tmpfile");
+        return 1;
+    }
+
+    elapsed = now_ns();
+    for (i = first; i < argc; i++)
+    {
+        if (write_dump(&seq, (uint32_t)(i - first + 1), argv[i]) != 0)
+        {
+            status = 1;
+        }
+    }
+
+    if (fflush(seq.out) != 0)
+    {
+        perror("write");
+        return 1;
+    }
+    elapsed = now_ns() - elapsed + 1U;
+
+    if (bench)
+    {
+        printf("protobuf: %.1f MB in %.1f ms\n", (double)ftell(seq.out) / 1e6,
+               (double)elapsed / 1e6);
+        fclose(seq.out);
+    }
+
+    return status;
+}
@@ -0,0 +1,271 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_query.c
+ * \brief Host tool keeping boot records of many boots in a columnar archive
+ *
+ * Usage: bootrecord_query -a <archive> <dump.bin|directory>...
+ *        bootrecord_query <archive> <name> [<days>]
+ *
+ * With -a the dumps, oldest first, are appended to the archive as new
+ * boots, dated by the modification time of their files. Otherwise every
+ * record of a profile name is printed with the date of its boot, optionally
+ * limited to the boots of the last days, to follow how it trends over time.
+ * Only the boot, wall-clock, stage, name and time columns are read, and
+ * blocks holding other names or older boots are skipped.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_archive.h"
+#include "bootrecord_ingest.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Dump file to append, with the time it was taken
+ */
+typedef struct
+{
+    const char *path;
+    uint64_t wall;
+} dump_file_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+static int compare_files(const void *a, const void *b)
+{
+    const dump_file_t *fa = a;
+    const dump_file_t *fb = b;
+
+    if (fa->wall != fb->wall)
+    {
+        return (fa->wall < fb->wall) ? -1 : 1;
+    }
+
+    return strcmp(fa->path, fb->path);
+}
+
+static int append_dumps(const char *archive_path, int count, char **args)
+{
+    boot_record_archive_writer_t writer;
+    boot_record_path_list_t list;
+    boot_record_status_t ret;
+    boot_record_dump_t dump;
+    dump_file_t *files;
+    struct stat st;
+    int status = 0;
+    uint32_t i;
+    int arg;
+
+    boot_record_path_list_init(&list);
+    for (arg = 0; arg < count; arg++)
+    {
+        ret = boot_record_path_list_add(&list, args[arg]);
+        if (ret == BOOT_RECORD_ERR_INSUFFICIENT_MEM)
+        {
+            perror("malloc");
+            boot_record_path_list_free(&list);
+            return 1;
+        }
+        else if (ret != BOOT_RECORD_SUCCESS)
+        {
+            fprintf(stderr, "%s: %s\n", args[arg], strerror(errno));
+            status = 1;
+        }
+    }
+
+    files = malloc((list.count + 1U) * sizeof(*files));
+    if (!files)
+    {
+        perror("malloc");
+        boot_record_path_list_free(&list);
+        return 1;
+    }
+
+    for (i = 0; i < list.count; i++)
+    {
+        files[i].path = list.paths[i];
+        files[i].wall = (stat(list.paths[i], &st) == 0) ? (uint64_t)st.st_mtime : 0U;
+    }
+    qsort(files, list.count, sizeof(*files), compare_files);
+
+    ret = boot_record_archive_writer_open(&writer, archive_path);
+    if (ret != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", archive_path,
+                (ret == BOOT_RECORD_ERR_FORMAT) ? "not a boot record archive" :
+                strerror(errno));
+        free(files);
+        boot_record_path_list_free(&list);
+        return 1;
+    }
+
+    for (i = 0; i < list.count; i++)
+    {
+        if (boot_record_dump_open(&dump, files[i].path, 0, 0) != BOOT_RECORD_SUCCESS)
+        {
+            fprintf(stderr, "%s: %s\n", files[i].path, strerror(errno));
+            status = 1;
+            continue;
+        }
+
+        ret = boot_record_archive_add_dump(&writer, &dump, files[i].wall);
+        boot_record_dump_close(&dump);
+
+        if (ret == BOOT_RECORD_ERR_FORMAT)
+        {
+            fprintf(stderr, "%s: not a valid boot record dump\n", files[i].path);
+            status = 1;
+        }
+        else if (ret != BOOT_RECORD_SUCCESS)
+        {
+            perror(archive_path);
+            status = 1;
+            break;
+        }
+    }
+
+    if (boot_record_archive_writer_close(&writer) != BOOT_RECORD_SUCCESS)
+    {
+        perror(archive_path);
+        status = 1;
+    }
+
+    free(files);
+    boot_record_path_list_free(&list);
+
+    return status;
+}
+
+static void print_row(const uint64_t *row, void *arg)
+{
+    char date[32];
+    struct tm tm;
+    time_t wall = (time_t)row[BOOT_RECORD_ARCHIVE_COL_WALL];
+
+    (void)arg;
+
+    if (!gmtime_r(&wall, &tm) ||
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm) == 0)
+    {
+        date[0] = '\0';
+    }
+
+    printf("%-20s %8" PRIu64 " 0x%08" PRIx64 " %14.3f\n", date,
+           row[BOOT_RECORD_ARCHIVE_COL_BOOT], row[BOOT_RECORD_ARCHIVE_COL_STAGE],
+           (double)row[BOOT_RECORD_ARCHIVE_COL_TIME] / 1e6);
+}
+
+static int query_name(const char *archive_path, const char *name, const char *days)
+{
+    boot_record_archive_query_t query;
+    boot_record_archive_scan_t scan;
+    boot_record_archive_t archive;
+    boot_record_status_t ret;
+    uint32_t name_index;
+
+    ret = boot_record_archive_open(&archive, archive_path);
+    if (ret != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", archive_path,
+                (ret == BOOT_RECORD_ERR_FORMAT) ? "not a boot record archive" :
+                strerror(errno));
+        return 1;
+    }
+
+    name_index = boot_record_archive_find_name(&archive, name);
+    if (name_index == BOOT_RECORD_NAME_ID_NONE)
+    {
+        fprintf(stderr, "%s: no records of %s\n", archive_path, name);
+        boot_record_archive_close(&archive);
+        return 1;
+    }
+
+    boot_record_archive_query_init(&query);
+    query.columns = BOOT_RECORD_ARCHIVE_COLUMN(BOOT_RECORD_ARCHIVE_COL_BOOT) |
+                    BOOT_RECORD_ARCHIVE_COLUMN(BOOT_RECORD_ARCHIVE_COL_WALL) |
+                    BOOT_RECORD_ARCHIVE_COLUMN(BOOT_RECORD_ARCHIVE_COL_STAGE) |
+                    BOOT_RECORD_ARCHIVE_COLUMN(BOOT_RECORD_ARCHIVE_COL_TIME);
+    query.filter[BOOT_RECORD_ARCHIVE_COL_NAME].min = name_index;
+    query.filter[BOOT_RECORD_ARCHIVE_COL_NAME].max = name_index;
+    if (days)
+    {
+        query.filter[BOOT_RECORD_ARCHIVE_COL_WALL].min =
+            (uint64_t)time(NULL) - strtoull(days, NULL, 0) * 86400U;
+    }
+
+    printf("%-20s %8s %10s %14s\n", "date (UTC)", "boot", "stage", "time ms");
+    ret = boot_record_archive_scan(&archive, &query, print_row, NULL, &scan);
+    fprintf(stderr, "%" PRIu64 " records, %" PRIu32 " of %" PRIu32 " blocks read\n",
+            scan.rows, scan.blocks_read, archive.block_count);
+    boot_record_archive_close(&archive);
+
+    if (ret != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: corrupt block\n", archive_path);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 4 && strcmp(argv[1], "-a") == 0)
+    {
+        return append_dumps(argv[2], argc - 3, argv + 3);
+    }
+
+    if (argc == 3 || argc == 4)
+    {
+        return query_name(argv[1], argv[2], (argc == 4) ? argv[3] : NULL);
+    }
+
+    fprintf(stderr, "usage: %s -a <archive> <dump.bin|directory>...\n"
+            "       %s <archive> <name> [<days>]\n", argv[0], argv[0]);
+    return 2;
+}
@@ -0,0 +1,578 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_reader.c
+ * \brief Linux userspace reader for boot record dumps
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_reader.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Four 64-bit lanes only pay off with AVX2; lane shuffles need GCC 12 or
+ * later, or Clang */
+#if defined(__AVX2__) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 12))
+#define BOOT_RECORD_PREFIX_SUM_VECTOR       (1)
+
+typedef uint64_t boot_record_u64x4_t __attribute__((vector_size(32)));
+#endif
+
+/* Most records in a stream block, two bytes each */
+#define BOOT_RECORD_BLOCK_RECORDS_MAX \
+    ((BOOT_RECORD_STREAM_BLOCK_SIZE - sizeof(boot_record_stream_block_t)) / 2U)
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Map a boot record dump read only
+ */
+boot_record_status_t boot_record_dump_open(boot_record_dump_t *dump,
+                                          const char *path,
+                                          uint64_t offset,
+                                          uint32_t size)
+{
+    struct stat st;
+    long page_size = sysconf(_SC_PAGESIZE);
+    uint64_t delta;
+    void *map_addr;
+    int saved_errno;
+    int fd;
+
+    if (!dump || !path || page_size <= 0)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    memset(dump, 0, sizeof(*dump));
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    /* Devices such as /dev/mem report no size, so theirs must be given */
+    if (size == 0)
+    {
+        if (fstat(fd, &st) != 0)
+        {
+            saved_errno = errno;
+        }
+        else if (!S_ISREG(st.st_mode) || offset >= (uint64_t)st.st_size ||
+                 (uint64_t)st.st_size - offset > UINT32_MAX)
+        {
+            saved_errno = EINVAL;
+        }
+        else
+        {
+            saved_errno = 0;
+        }
+
+        if (saved_errno)
+        {
+            close(fd);
+            errno = saved_errno;
+            return BOOT_RECORD_ERR_INVALID_PARAMS;
+        }
+
+        size = (uint32_t)((uint64_t)st.st_size - offset);
+    }
+
+    /* mmap needs a page aligned offset, the dump starts delta bytes in */
+    delta = offset % (uint64_t)page_size;
+    map_addr = mmap(NULL, (size_t)(delta + size), PROT_READ, MAP_SHARED, fd,
+                    (off_t)(offset - delta));
+    saved_errno = errno;
+    close(fd);
+
+    if (map_addr == MAP_FAILED)
+    {
+        errno = saved_errno;
+        return BOOT_RECORD_ERR_INVALID_PARAMS;
+    }
+
+    dump->map_addr = map_addr;
+    dump->map_size = (size_t)(delta + size);
+    dump->data = (const uint8_t *)map_addr + delta;
+    dump->size = size;
+
+    return BOOT_RECORD_SUCCESS;
+}
+
+/**
+ * Unmap a dump mapped by boot_record_dump_open
+ */
+void boot_record_dump_close(boot_record_dump_t *dump)
+{
+    if (dump && dump->map_addr)
+    {
+        munmap(dump->map_addr, dump->map_size);
+        memset(dump, 0, sizeof(*dump));
+    }
+}
+
+/**
+ * Start walking the stages of a dump
+ */
+void boot_record_stage_iter_init(boot_record_stage_iter_t *iter,
+                                 const boot_record_dump_t *dump)
+{
+    const boot_record_chain_t *chain;
+
+    memset(iter, 0, sizeof(*iter));
+    iter->dump = dump;
+
+    chain = (const boot_record_chain_t *)dump->data;
+    if (dump->size >= sizeof(*chain) && chain->magic == BOOT_RECORD_CHAIN_MAGIC)
+    {
+        iter->chain = chain;
+        if (chain->stage_count > BOOT_RECORD_MAX_STAGES)
+        {
+            iter->status = BOOT_RECORD_ERR_FORMAT;
+        }
+    }
+}
+
+/**
+ * Get the next stage of a dump
+ */
+const boot_stage_record_t *boot_record_stage_iter_next(boot_record_stage_iter_t *iter)
+{
+    const boot_record_chain_entry_t *entry;
+    const boot_stage_record_t *stage;
+    const uint8_t *data = iter->dump->data;
+    uint32_t size = iter->dump->size;
+
+    if (iter->status != BOOT_RECORD_SUCCESS)
+    {
+        return NULL;
+    }
+
+    if (iter->chain)
+    {
+        if (iter->next >= iter->chain->stage_count)
+        {
+            return NULL;
+        }
+
+        entry = &iter->chain->stages[iter->next];
+        if (entry->offset > size || entry->size > size - entry->offset)
+        {
+            iter->status = BOOT_RECORD_ERR_FORMAT;
+            return NULL;
+        }
+
+        data += entry->offset;
+        size = entry->size;
+    }
+    else if (iter->next > 0)
+    {
+        return NULL;
+    }
+
+    iter->status = boot_record_validate(data, size, &stage);
+    if (iter->status != BOOT_RECORD_SUCCESS)
+    {
+        return NULL;
+    }
+
+    iter->next++;
+
+    return stage;
+}
+
+/**
+ * Point a record iterator at the start of its current sub-stage
+ */
+static void boot_record_record_iter_load(boot_record_record_iter_t *iter)
+{
+    iter->current = (iter->stage->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+                    boot_record_get_cpu_stage(iter->stage, iter->cpu_id) :
+                    iter->stage;
+    iter->index = 0;
+    iter->count = boot_record_get_count(iter->current);
+    iter->stream_left = 0;
+    iter->stream_block = 0;
+}
+
+/**
+ * Move a record iterator to the next sub-stage
+ *
+ * \return 1 if there is one, 0 after the last
+ */
+static int boot_record_record_iter_advance(boot_record_record_iter_t *iter)
+{
+    if (!(iter->stage->flags & BOOT_RECORD_FLAG_PER_CPU) ||
+        iter->cpu_id + 1U >= iter->stage->cpu_count)
+    {
+        return 0;
+    }
+
+    iter->cpu_id++;
+    boot_record_record_iter_load(iter);
+
+    return 1;
+}
+
+/**
+ * Start walking the records of a stage
+ */
+void boot_record_record_iter_init(boot_record_record_iter_t *iter,
+                                  const boot_stage_record_t *stage)
+{
+    memset(iter, 0, sizeof(*iter));
+    iter->stage = stage;
+    boot_record_record_iter_load(iter);
+}
+
+/**
+ * Get the next profile record of a stage storing names inline
+ */
+const boot_record_profile_t *boot_record_record_iter_next(boot_record_record_iter_t *iter)
+{
+    const boot_record_profile_t *profile;
+
+    if (iter->stage->flags & BOOT_RECORD_FLAG_NAME_IDS)
+    {
+        return NULL;
+    }
+
+    do
+    {
+        while (iter->index < iter->count)
+        {
+            if (boot_record_get_profile(iter->current, iter->index++,
+                                        &profile) == BOOT_RECORD_SUCCESS)
+            {
+                return profile;
+            }
+        }
+    } while (boot_record_record_iter_advance(iter));
+
+    return NULL;
+}
+
+/**
+ * Decode a LEB128 varint that must end before end
+ *
+ * \return 1 on success, 0 if it is truncated or too long
+ */
+static inline int boot_record_get_varint(const uint8_t **pos, const uint8_t *end,
+                                         uint64_t *value)
+{
+    const uint8_t *p = *pos;
+    uint64_t result;
+    uint32_t shift = 7;
+
+    if (p >= end)
+    {
+        return 0;
+    }
+
+    /* Names and short deltas take one byte */
+    if (*p < 0x80U)
+    {
+        *value = *p;
+        *pos = p + 1;
+        return 1;
+    }
+
+    result = *p++ & 0x7FU;
+    do
+    {
+        if (p >= end || shift > 63U)
+        {
+            return 0;
+        }
+        result |= (uint64_t)(*p & 0x7FU) << shift;
+        shift += 7U;
+    } while (*p++ & 0x80U);
+
+    *pos = p;
+    *value = result;
+
+    return 1;
+}
+
+/**
+ * Get a block of a record stream
+ *
+ * \return Block, NULL past the written part of the stream
+ */
+static const boot_record_stream_block_t *boot_record_stream_block(const boot_stage_record_t *stage,
+                                                                 uint32_t index)
+{
+    if ((uint64_t)index * BOOT_RECORD_STREAM_BLOCK_SIZE >= stage->stream_size)
+    {
+        return NULL;
+    }
+
+    return (const boot_record_stream_block_t *)((const uint8_t *)stage->profiles +
+                                                index * BOOT_RECORD_STREAM_BLOCK_SIZE);
+}
+
+/**
+ * Decode the next record of the record stream of the current sub-stage
+ *
+ * \return 1 if a record was decoded, 0 at the end of the stream or at a
+ *         corrupt block
+ */
+static int boot_record_record_iter_next_stream(boot_record_record_iter_t *iter,
+                                               boot_record_event_t *event)
+{
+    const boot_record_stream_block_t *block;
+    uint64_t name_id;
+    uint64_t delta;
+
+    if (iter->index >= iter->count)
+    {
+        return 0;
+    }
+
+    if (iter->stream_left == 0)
+    {
+        block = boot_record_stream_block(iter->current, iter->stream_block++);
+        if (!block || block->first != iter->index || block->count == 0)
+        {
+            return 0;
+        }
+
+        iter->stream_pos = (const uint8_t *)(block + 1);
+        iter->stream_end = (const uint8_t *)block + BOOT_RECORD_STREAM_BLOCK_SIZE;
+        iter->stream_time = block->time;
+        iter->stream_left = block->count;
+    }
+
+    if (!boot_record_get_varint(&iter->stream_pos, iter->stream_end, &name_id) ||
+        !boot_record_get_varint(&iter->stream_pos, iter->stream_end, &delta))
+    {
+        return 0;
+    }
+
+    iter->stream_time += delta;
+    iter->stream_left--;
+    iter->index++;
+
+    event->cpu_id = iter->cpu_id;
+    event->name_id = (uint32_t)name_id;
+    event->name = boot_record_get_name(iter->current, event->name_id);
+    event->kind = BOOT_RECORD_KIND_POINT;
+    event->depth = 0;
+    event->link = BOOT_RECORD_INDEX_NONE;
+    event->wait_id = BOOT_RECORD_NAME_ID_NONE;
+    event->time = iter->stream_time;
+
+    return 1;
+}
+
+/**
+ * Decode the next record of a stage of any layout
+ */
+int boot_record_record_iter_next_event(boot_record_record_iter_t *iter,
+                                       boot_record_event_t *event)
+{
+    do
+    {
+        if (iter->current->flags & BOOT_RECORD_FLAG_STREAM)
+        {
+            if (boot_record_record_iter_next_stream(iter, event))
+            {
+                return 1;
+            }
+            continue;
+        }
+
+        while (iter->index < iter->count)
+        {
+            if (boot_record_get_event(iter->current, iter->index++,
+                                      event) == BOOT_RECORD_SUCCESS)
+            {
+                event->cpu_id = iter->cpu_id;
+                return 1;
+            }
+        }
+    } while (boot_record_record_iter_advance(iter));
+
+    return 0;
+}
+
+/**
+ * Decode consecutive records of a record stream into arrays
+ */
+uint32_t boot_record_stream_decode(const boot_stage_record_t *stage,
+                                   uint32_t first, uint32_t count,
+                                   uint32_t *name_ids, uint64_t *times)
+{
+    uint64_t deltas[BOOT_RECORD_BLOCK_RECORDS_MAX];
+    uint32_t names[BOOT_RECORD_BLOCK_RECORDS_MAX];
+    const boot_record_stream_block_t *block;
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint64_t name_id;
+    uint64_t base;
+    uint32_t decoded = 0;
+    uint32_t low = 0;
+    uint32_t high;
+    uint32_t mid;
+    uint32_t skip;
+    uint32_t take;
+    uint32_t n;
+
+    if (!stage || !(stage->flags & BOOT_RECORD_FLAG_STREAM))
+    {
+        return 0;
+    }
+
+    /* Last block starting at or before the first record */
+    high = (stage->stream_size + BOOT_RECORD_STREAM_BLOCK_SIZE - 1U) /
+           BOOT_RECORD_STREAM_BLOCK_SIZE;
+    while (high - low > 1U)
+    {
+        mid = low + (high - low) / 2U;
+        if (boot_record_stream_block(stage, mid)->first <= first)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    while (decoded < count && (block = boot_record_stream_block(stage, low++)) != NULL)
+    {
+        if (block->count > BOOT_RECORD_BLOCK_RECORDS_MAX || first < block->first ||
+            first - block->first >= block->count)
+        {
+            break;
+        }
+
+        /* Split the block into names and deltas */
+        pos = (const uint8_t *)(block + 1);
+        end = (const uint8_t *)block + BOOT_RECORD_STREAM_BLOCK_SIZE;
+        for (n = 0; n < block->count; n++)
+        {
+            if (!boot_record_get_varint(&pos, end, &name_id) ||
+                !boot_record_get_varint(&pos, end, &deltas[n]))
+            {
+                break;
+            }
+            names[n] = (uint32_t)name_id;
+        }
+
+        /* Records before first only move the base */
+        skip = first - block->first;
+        base = block->time;
+        for (take = 0; take < skip && take < n; take++)
+        {
+            base += deltas[take];
+        }
+
+        take = (n > skip) ? n - skip : 0U;
+        if (take > count - decoded)
+        {
+            take = count - decoded;
+        }
+
+        memcpy(name_ids + decoded, names + skip, take * sizeof(*name_ids));
+        memcpy(times + decoded, deltas + skip, take * sizeof(*times));
+        boot_record_prefix_sum(times + decoded, take, base);
+
+        decoded += take;
+        first += take;
+        if (n < block->count)
+        {
+            break;
+        }
+    }
+
+    return decoded;
+}
+
+/**
+ * Replace deltas by timestamps
+ */
+void boot_record_prefix_sum(uint64_t *values, uint32_t count, uint64_t base)
+{
+#ifdef BOOT_RECORD_PREFIX_SUM_VECTOR
+    const boot_record_u64x4_t zero = { 0, 0, 0, 0 };
+    boot_record_u64x4_t carry = { base, base, base, base };
+    boot_record_u64x4_t x;
+    uint32_t i;
+
+    for (i = 0; i + 4U <= count; i += 4U)
+    {
+        /* Sums within the lanes in two shifted adds, then the carry of the
+         * values before */
+        memcpy(&x, values + i, sizeof(x));
+        x += __builtin_shufflevector(zero, x, 0, 4, 5, 6);
+        x += __builtin_shufflevector(zero, x, 0, 1, 4, 5);
+        x += carry;
+        carry = __builtin_shufflevector(x, x, 3, 3, 3, 3);
+        memcpy(values + i, &x, sizeof(x));
+    }
+
+    boot_record_prefix_sum_scalar(values + i, count - i, carry[0]);
+#else
+    boot_record_prefix_sum_scalar(values, count, base);
+#endif
+}
+
+/**
+ * Scalar version of boot_record_prefix_sum
+ */
+void boot_record_prefix_sum_scalar(uint64_t *values, uint32_t count,
+                                   uint64_t base)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        base += values[i];
+        values[i] = base;
+    }
+}
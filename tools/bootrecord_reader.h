@@ -0,0 +1,245 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_reader.h
+ * \brief Linux userspace reader for boot record dumps
+ *
+ * Maps a dump file, a reserved-memory device or a range of /dev/mem read
+ * only and iterates over its stages and records in place. Every stage is
+ * checked with boot_record_validate before it is handed out, so a corrupt
+ * or foreign dump can't make the iterators read outside the mapping.
+ */
+
+#ifndef BOOT_RECORD_READER_H
+#define BOOT_RECORD_READER_H
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bootrecord.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Boot record dump mapped into memory
+ */
+typedef struct
+{
+    /* Start of the mapping, page aligned */
+    void *map_addr;
+    /* Length of the mapping */
+    size_t map_size;
+    /* Start of the dump inside the mapping */
+    const uint8_t *data;
+    /* Size of the dump */
+    uint32_t size;
+} boot_record_dump_t;
+
+/**
+ * Position in the stages of a dump, a single stage or the stages of a chain
+ */
+typedef struct
+{
+    /* Dump being walked */
+    const boot_record_dump_t *dump;
+    /* Chain of the dump, NULL for a dump holding a single stage */
+    const boot_record_chain_t *chain;
+    /* Index of the next stage */
+    uint32_t next;
+    /* Why the walk stopped, BOOT_RECORD_SUCCESS after the last stage */
+    boot_record_status_t status;
+} boot_record_stage_iter_t;
+
+/**
+ * Position in the records of a stage, one per-CPU sub-stage after another
+ */
+typedef struct
+{
+    /* Validated top-level stage */
+    const boot_stage_record_t *stage;
+    /* Stage or sub-stage being read */
+    const boot_stage_record_t *current;
+    /* Index of the sub-stage being read, 0 without per-CPU sub-stages */
+    uint32_t cpu_id;
+    /* Logging-order index of the next record in the current stage */
+    uint32_t index;
+    /* Number of readable records in the current stage */
+    uint32_t count;
+    /* Next record and end of the current block of a record stream */
+    const uint8_t *stream_pos;
+    const uint8_t *stream_end;
+    /* Time of the previous record of a record stream */
+    uint64_t stream_time;
+    /* Records left in the current block of a record stream */
+    uint32_t stream_left;
+    /* Index of the next block of a record stream */
+    uint32_t stream_block;
+} boot_record_record_iter_t;
+
+/* ========================================================================== */
+/*                          Function Declarations                             */
+/* ========================================================================== */
+
+/**
+ * Map a boot record dump read only
+ *
+ * \param dump Dump to initialize
+ * \param path File, reserved-memory device or /dev/mem
+ * \param offset Offset of the dump in the file, need not be page aligned
+ * \param size Size of the dump, 0 for the rest of a regular file
+ * \return BOOT_RECORD_SUCCESS on success, BOOT_RECORD_ERR_INVALID_PARAMS
+ *         if the file can't be opened or mapped, with errno telling why
+ */
+boot_record_status_t boot_record_dump_open(boot_record_dump_t *dump,
+                                          const char *path,
+                                          uint64_t offset,
+                                          uint32_t size);
+
+/**
+ * Unmap a dump mapped by boot_record_dump_open
+ *
+ * \param dump Dump to unmap
+ */
+void boot_record_dump_close(boot_record_dump_t *dump);
+
+/**
+ * Start walking the stages of a dump
+ *
+ * \param iter Iterator to initialize
+ * \param dump Mapped dump
+ */
+void boot_record_stage_iter_init(boot_record_stage_iter_t *iter,
+                                 const boot_record_dump_t *dump);
+
+/**
+ * Get the next stage of a dump
+ *
+ * \param iter Iterator initialized by boot_record_stage_iter_init
+ * \return Validated stage, NULL after the last stage or if the next stage is
+ *         invalid, which iter->status tells apart
+ */
+const boot_stage_record_t *boot_record_stage_iter_next(boot_record_stage_iter_t *iter);
+
+/**
+ * Start walking the records of a stage
+ *
+ * Records are returned in logging order, one per-CPU sub-stage after another.
+ * Use boot_record_merge for a single time-ordered walk instead.
+ *
+ * \param iter Iterator to initialize
+ * \param stage Stage returned by boot_record_stage_iter_next
+ */
+void boot_record_record_iter_init(boot_record_record_iter_t *iter,
+                                  const boot_stage_record_t *stage);
+
+/**
+ * Get the next profile record of a stage storing names inline
+ *
+ * Records whose writer did not finish are skipped.
+ *
+ * \param iter Iterator initialized by boot_record_record_iter_init
+ * \return Record in place, NULL after the last record or if the stage uses
+ *         name IDs
+ */
+const boot_record_profile_t *boot_record_record_iter_next(boot_record_record_iter_t *iter);
+
+/**
+ * Decode the next record of a stage of any layout
+ *
+ * Records whose writer did not finish are skipped. Record streams are
+ * decoded sequentially, one block after another.
+ *
+ * \param iter Iterator initialized by boot_record_record_iter_init
+ * \param event Pointer to receive the record, with the sub-stage as cpu_id
+ * \return 1 if a record was decoded, 0 after the last record
+ */
+int boot_record_record_iter_next_event(boot_record_record_iter_t *iter,
+                                       boot_record_event_t *event);
+
+/**
+ * Decode consecutive records of a record stream into arrays
+ *
+ * Decoding starts at the sync point of the block holding record first, so
+ * any range is decoded without reading earlier blocks. Each block is split
+ * into name IDs and deltas in one pass over its bytes, then
+ * boot_record_prefix_sum turns the deltas into timestamps.
+ *
+ * \param stage Stage or per-CPU sub-stage with BOOT_RECORD_FLAG_STREAM
+ * \param first Logging-order index of the first record
+ * \param count Maximum number of records to decode
+ * \param name_ids Array receiving count name IDs
+ * \param times Array receiving count timestamps
+ * \return Number of records decoded, fewer than count at the end of the
+ *         stream or at a corrupt block
+ */
+uint32_t boot_record_stream_decode(const boot_stage_record_t *stage,
+                                   uint32_t first, uint32_t count,
+                                   uint32_t *name_ids, uint64_t *times);
+
+/**
+ * Replace deltas by timestamps, values[i] = base + values[0] + ... + values[i]
+ *
+ * Built with AVX2 by GCC 12 or later or by Clang, it adds four values at a
+ * time in vector registers, otherwise one at a time.
+ *
+ * \param values Deltas, replaced by the timestamps
+ * \param count Number of values
+ * \param base Timestamp the first delta is relative to
+ */
+void boot_record_prefix_sum(uint64_t *values, uint32_t count, uint64_t base);
+
+/**
+ * Scalar version of boot_record_prefix_sum, for comparison
+ *
+ * \param values Deltas, replaced by the timestamps
+ * \param count Number of values
+ * \param base Timestamp the first delta is relative to
+ */
+void boot_record_prefix_sum_scalar(uint64_t *values, uint32_t count,
+                                   uint64_t base);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_RECORD_READER_H */
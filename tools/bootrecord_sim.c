@@ -0,0 +1,1075 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_sim.c
+ * \brief Host tool predicting the boot time of schedule changes
+ *
+ * Usage: bootrecord_sim [-b] <dump.bin> <config>
+ *
+ * Builds the dependency graph of a recorded boot, as bootrecord_critical
+ * does, then replays it once per variant of the config file and prints the
+ * predicted boot time and critical path. With -b it replays the variants
+ * repeatedly and reports how many it simulates per second.
+ *
+ * The config file holds one change per line, '#' starting a comment:
+ *
+ *   variant <label>               start a new variant
+ *   scale <name> <factor>         scale the work of the steps ending at name
+ *   set <name> <us>               set that work, in microseconds
+ *   move <name> <cpu>             run the records named name on another CPU
+ *   after <name> <other>          make name also wait for the last other
+ *   drop <name> <other>           remove the wait of name for other
+ *   sweep <name> <from> <to> <n>  add n variants scaling name from..to
+ *
+ * Changes before the first variant apply to every variant. The work of a
+ * record is the step from its latest dependency to the record; for a span
+ * that is the work before its end record, so begin records are not scaled
+ * and a dependency is added to every record named name except an end. A
+ * moved record keeps its work and runs on the target CPU between the
+ * records around its recorded time. Only waits can be dropped; the order
+ * of the records of one CPU changes through moves.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_dag.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Minimum time spent replaying the variants with -b */
+#define BENCH_MIN_NS                        (500000000ULL)
+
+/* Longest config line and variant label */
+#define LINE_MAX_LEN                        (256U)
+#define LABEL_MAX_LEN                       (48U)
+
+/* Changes */
+#define CHANGE_SCALE                        (0U)
+#define CHANGE_SET                          (1U)
+#define CHANGE_MOVE                         (2U)
+#define CHANGE_AFTER                        (3U)
+#define CHANGE_DROP                         (4U)
+
+#define NONE                                BOOT_RECORD_DAG_NONE
+
+/**
+ * Change of a variant
+ */
+typedef struct
+{
+    uint32_t type;
+    /* Name index of the records changed */
+    uint32_t name;
+    /* Name index waited for, or CPU to move to */
+    uint32_t other;
+    /* Scale factor, or work in nanoseconds */
+    double value;
+} change_t;
+
+/**
+ * Variant, its changes following the common ones
+ */
+typedef struct
+{
+    char label[LABEL_MAX_LEN];
+    uint32_t first_change;
+    uint32_t change_count;
+} variant_t;
+
+/**
+ * Dependency edge
+ */
+typedef struct
+{
+    uint32_t from;
+    uint32_t to;
+} edge_t;
+
+/**
+ * Recorded boot and the scratch state of a replay
+ */
+typedef struct
+{
+    const boot_record_dag_t *dag;
+    uint32_t n;
+    /* Distinct names, and the name index of every node */
+    char (*names)[BOOT_RECORD_NAME_LEN];
+    uint32_t name_count;
+    uint32_t *name_of;
+    /* Recorded schedule */
+    uint64_t *base_pin;
+    uint32_t *base_prev;
+    uint32_t *base_next;
+    edge_t *base_waits;
+    uint32_t base_wait_count;
+    /* Schedule of the variant being replayed */
+    uint64_t *work;
+    uint64_t *pin;
+    uint32_t *cpu;
+    uint32_t *prev;
+    uint32_t *next;
+    edge_t *waits;
+    uint32_t wait_count;
+    uint32_t wait_capacity;
+    /* Replay state */
+    edge_t *edges;
+    uint32_t edge_capacity;
+    uint32_t *succ_start;
+    uint32_t *succ;
+    uint32_t *indegree;
+    uint32_t *queue;
+    uint64_t *start;
+    uint64_t *finish;
+    uint32_t *crit;
+    uint32_t end;
+} sim_t;
+
+/**
+ * Parsed config file
+ */
+typedef struct
+{
+    change_t *changes;
+    uint32_t change_count;
+    uint32_t change_capacity;
+    /* Number of changes applied to every variant */
+    uint32_t common_count;
+    variant_t *variants;
+    uint32_t variant_count;
+    uint32_t variant_capacity;
+} config_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t find_name(const sim_t *sim, const char *name)
+{
+    uint32_t i;
+
+    for (i = 0; i < sim->name_count; i++)
+    {
+        if (strncmp(sim->names[i], name, BOOT_RECORD_NAME_LEN) == 0)
+        {
+            return i;
+        }
+    }
+
+    return NONE;
+}
+
+/**
+ * Take the recorded schedule of a graph
+ */
+static int sim_init(sim_t *sim, const boot_record_dag_t *dag)
+{
+    const boot_record_dag_node_t *node;
+    uint32_t n = dag->node_count;
+    uint32_t pred;
+    uint32_t i;
+
+    memset(sim, 0, sizeof(*sim));
+    sim->dag = dag;
+    sim->n = n;
+
+    sim->names = malloc((n + 1U) * sizeof(*sim->names));
+    sim->name_of = malloc((n + 1U) * sizeof(uint32_t));
+    sim->base_pin = malloc((n + 1U) * sizeof(uint64_t));
+    sim->base_prev = malloc((n + 1U) * sizeof(uint32_t));
+    sim->base_next = malloc((n + 1U) * sizeof(uint32_t));
+    sim->base_waits = malloc((n + 1U) * sizeof(edge_t));
+    sim->work = malloc((n + 1U) * sizeof(uint64_t));
+    sim->pin = malloc((n + 1U) * sizeof(uint64_t));
+    sim->cpu = malloc((n + 1U) * sizeof(uint32_t));
+    sim->prev = malloc((n + 1U) * sizeof(uint32_t));
+    sim->next = malloc((n + 1U) * sizeof(uint32_t));
+    sim->succ_start = malloc((n + 2U) * sizeof(uint32_t));
+    sim->indegree = malloc((n + 1U) * sizeof(uint32_t));
+    sim->queue = malloc((n + 1U) * sizeof(uint32_t));
+    sim->start = malloc((n + 1U) * sizeof(uint64_t));
+    sim->finish = malloc((n + 1U) * sizeof(uint64_t));
+    sim->crit = malloc((n + 1U) * sizeof(uint32_t));
+    if (!sim->names || !sim->name_of || !sim->base_pin || !sim->base_prev ||
+        !sim->base_next || !sim->base_waits || !sim->work || !sim->pin ||
+        !sim->cpu || !sim->prev || !sim->next || !sim->succ_start ||
+        !sim->indegree || !sim->queue || !sim->start || !sim->finish ||
+        !sim->crit)
+    {
+        return -1;
+    }
+
+    memset(sim->base_next, 0xFF, n * sizeof(uint32_t));
+
+    for (i = 0; i < n; i++)
+    {
+        node = &dag->nodes[i];
+
+        sim->name_of[i] = find_name(sim, node->name);
+        if (sim->name_of[i] == NONE)
+        {
+            memcpy(sim->names[sim->name_count], node->name, BOOT_RECORD_NAME_LEN);
+            sim->name_of[i] = sim->name_count++;
+        }
+
+        /* Roots stay pinned at their recorded time */
+        sim->base_pin[i] = (node->critical_pred == NONE) ? node->time : 0U;
+
+        pred = node->pred[BOOT_RECORD_DAG_EDGE_CPU];
+        sim->base_prev[i] = pred;
+        if (pred != NONE)
+        {
+            sim->base_next[pred] = i;
+        }
+
+        pred = node->pred[BOOT_RECORD_DAG_EDGE_WAIT];
+        if (pred != NONE)
+        {
+            sim->base_waits[sim->base_wait_count].from = pred;
+            sim->base_waits[sim->base_wait_count].to = i;
+            sim->base_wait_count++;
+        }
+    }
+
+    return 0;
+}
+
+static void sim_free(sim_t *sim)
+{
+    free(sim->names);
+    free(sim->name_of);
+    free(sim->base_pin);
+    free(sim->base_prev);
+    free(sim->base_next);
+    free(sim->base_waits);
+    free(sim->work);
+    free(sim->pin);
+    free(sim->cpu);
+    free(sim->prev);
+    free(sim->next);
+    free(sim->waits);
+    free(sim->edges);
+    free(sim->succ_start);
+    free(sim->succ);
+    free(sim->indegree);
+    free(sim->queue);
+    free(sim->start);
+    free(sim->finish);
+    free(sim->crit);
+}
+
+/**
+ * Add a dependency edge to the variant being replayed
+ */
+static int sim_add_wait(sim_t *sim, uint32_t from, uint32_t to)
+{
+    edge_t *grown;
+
+    if (sim->wait_count == sim->wait_capacity)
+    {
+        sim->wait_capacity = sim->wait_capacity ? 2U * sim->wait_capacity : 64U;
+        grown = realloc(sim->waits, sim->wait_capacity * sizeof(*grown));
+        if (!grown)
+        {
+            return -1;
+        }
+        sim->waits = grown;
+    }
+
+    sim->waits[sim->wait_count].from = from;
+    sim->waits[sim->wait_count].to = to;
+    sim->wait_count++;
+
+    return 0;
+}
+
+/**
+ * Run a node on another CPU, between the records around its recorded time
+ */
+static void sim_move(sim_t *sim, uint32_t node, uint32_t cpu)
+{
+    const boot_record_dag_node_t *nodes = sim->dag->nodes;
+    uint32_t stage = nodes[node].stage_index;
+    uint32_t before = NONE;
+    uint32_t after = NONE;
+    uint32_t prev = sim->prev[node];
+    uint32_t next = sim->next[node];
+    uint32_t i;
+
+    if (sim->cpu[node] == cpu)
+    {
+        return;
+    }
+
+    /* Unlink; a new first record of the CPU starts when the old one did */
+    if (prev != NONE)
+    {
+        sim->next[prev] = next;
+    }
+    if (next != NONE)
+    {
+        sim->prev[next] = prev;
+        if (prev == NONE && sim->pin[node] > sim->pin[next])
+        {
+            sim->pin[next] = sim->pin[node];
+        }
+    }
+
+    /* Nodes of a stage are contiguous and sorted by recorded time */
+    for (i = node; i > 0 && nodes[i - 1U].stage_index == stage; i--)
+    {
+    }
+    for (; i < sim->n && nodes[i].stage_index == stage; i++)
+    {
+        if (i == node || sim->cpu[i] != cpu)
+        {
+            continue;
+        }
+
+        if (nodes[i].time <= nodes[node].time)
+        {
+            before = i;
+        }
+        else if (after == NONE)
+        {
+            after = i;
+        }
+    }
+
+    /* Follow the chain, earlier moves may have reordered it */
+    if (before != NONE)
+    {
+        after = sim->next[before];
+        sim->next[before] = node;
+    }
+    else if (after != NONE)
+    {
+        while (sim->prev[after] != NONE)
+        {
+            after = sim->prev[after];
+        }
+    }
+
+    sim->prev[node] = before;
+    sim->next[node] = after;
+    if (after != NONE)
+    {
+        sim->prev[after] = node;
+    }
+    sim->cpu[node] = cpu;
+}
+
+/**
+ * Apply one change to the variant being replayed
+ */
+static int sim_apply(sim_t *sim, const change_t *change)
+{
+    uint32_t source = NONE;
+    uint32_t kind;
+    uint32_t i;
+    uint32_t j;
+
+    if (change->type == CHANGE_AFTER)
+    {
+        for (i = sim->n; i-- > 0;)
+        {
+            if (sim->name_of[i] == change->other)
+            {
+                source = i;
+                break;
+            }
+        }
+    }
+
+    for (i = 0; i < sim->n; i++)
+    {
+        if (sim->name_of[i] != change->name)
+        {
+            continue;
+        }
+        kind = sim->dag->nodes[i].kind;
+
+        switch (change->type)
+        {
+            case CHANGE_SCALE:
+                if (kind != BOOT_RECORD_KIND_BEGIN)
+                {
+                    sim->work[i] = (uint64_t)((double)sim->work[i] * change->value + 0.5);
+                }
+                break;
+
+            case CHANGE_SET:
+                if (kind != BOOT_RECORD_KIND_BEGIN)
+                {
+                    sim->work[i] = (uint64_t)change->value;
+                }
+                break;
+
+            case CHANGE_MOVE:
+                sim_move(sim, i, change->other);
+                break;
+
+            case CHANGE_AFTER:
+                if (kind != BOOT_RECORD_KIND_END && source != i &&
+                    sim_add_wait(sim, source, i) != 0)
+                {
+                    return -1;
+                }
+                break;
+
+            default:
+                j = 0;
+                while (j < sim->wait_count)
+                {
+                    if (sim->waits[j].to == i &&
+                        sim->name_of[sim->waits[j].from] == change->other)
+                    {
+                        sim->waits[j] = sim->waits[--sim->wait_count];
+                    }
+                    else
+                    {
+                        j++;
+                    }
+                }
+                break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Collect the dependency edges of the variant being replayed
+ *
+ * \return Number of edges, NONE if out of memory
+ */
+static uint32_t sim_edges(sim_t *sim)
+{
+    const boot_record_dag_node_t *nodes = sim->dag->nodes;
+    uint32_t count = 0;
+    uint32_t first;
+    uint32_t mid;
+    uint32_t end;
+    uint32_t needed;
+    uint32_t i;
+    uint32_t j;
+    void *grown;
+
+    /* Worst case: every node has a CPU edge, plus the waits, plus every
+     * CPU of a stage waiting for every CPU of the previous one */
+    needed = sim->n + sim->wait_count +
+             nodes[sim->n - 1U].stage_index * BOOT_RECORD_MAX_CPUS * BOOT_RECORD_MAX_CPUS;
+
+    if (needed > sim->edge_capacity)
+    {
+        grown = realloc(sim->edges, needed * sizeof(*sim->edges));
+        if (!grown)
+        {
+            return NONE;
+        }
+        sim->edges = grown;
+        grown = realloc(sim->succ, needed * sizeof(*sim->succ));
+        if (!grown)
+        {
+            return NONE;
+        }
+        sim->succ = grown;
+        sim->edge_capacity = needed;
+    }
+
+    for (i = 0; i < sim->n; i++)
+    {
+        if (sim->prev[i] != NONE)
+        {
+            sim->edges[count].from = sim->prev[i];
+            sim->edges[count++].to = i;
+        }
+    }
+
+    for (i = 0; i < sim->wait_count; i++)
+    {
+        sim->edges[count++] = sim->waits[i];
+    }
+
+    /* The first record of each CPU of a stage waits for the last record of
+     * each CPU of the previous stage */
+    for (first = 0, mid = 0; mid < sim->n; first = mid, mid = end)
+    {
+        for (end = mid; end < sim->n && nodes[end].stage_index == nodes[mid].stage_index; end++)
+        {
+        }
+        if (mid == 0)
+        {
+            continue;
+        }
+
+        for (i = first; i < mid; i++)
+        {
+            if (sim->next[i] != NONE)
+            {
+                continue;
+            }
+            for (j = mid; j < end; j++)
+            {
+                if (sim->prev[j] == NONE)
+                {
+                    sim->edges[count].from = i;
+                    sim->edges[count++].to = j;
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Replay one variant, the recorded schedule if config is NULL
+ *
+ * \return Boot time in nanoseconds, NONE as a 64 bit value on a dependency
+ *         cycle or out of memory
+ */
+static uint64_t sim_run(sim_t *sim, const config_t *config, const variant_t *variant)
+{
+    uint64_t total = 0;
+    uint32_t edge_count;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t node;
+    uint32_t to;
+    uint32_t i;
+
+    memcpy(sim->pin, sim->base_pin, sim->n * sizeof(uint64_t));
+    memcpy(sim->prev, sim->base_prev, sim->n * sizeof(uint32_t));
+    memcpy(sim->next, sim->base_next, sim->n * sizeof(uint32_t));
+    sim->wait_count = 0;
+    for (i = 0; i < sim->n; i++)
+    {
+        sim->work[i] = sim->dag->nodes[i].work;
+        sim->cpu[i] = sim->dag->nodes[i].cpu_id;
+    }
+    for (i = 0; i < sim->base_wait_count; i++)
+    {
+        if (sim_add_wait(sim, sim->base_waits[i].from, sim->base_waits[i].to) != 0)
+        {
+            return UINT64_MAX;
+        }
+    }
+
+    for (i = 0; config && i < config->common_count; i++)
+    {
+        if (sim_apply(sim, &config->changes[i]) != 0)
+        {
+            return UINT64_MAX;
+        }
+    }
+    for (i = 0; config && variant && i < variant->change_count; i++)
+    {
+        if (sim_apply(sim, &config->changes[variant->first_change + i]) != 0)
+        {
+            return UINT64_MAX;
+        }
+    }
+
+    edge_count = sim_edges(sim);
+    if (edge_count == NONE)
+    {
+        return UINT64_MAX;
+    }
+
+    /* Successor lists by counting sort of the edges */
+    memset(sim->succ_start, 0, (sim->n + 2U) * sizeof(uint32_t));
+    memset(sim->indegree, 0, sim->n * sizeof(uint32_t));
+    for (i = 0; i < edge_count; i++)
+    {
+        sim->succ_start[sim->edges[i].from + 2U]++;
+        sim->indegree[sim->edges[i].to]++;
+    }
+    for (i = 2; i < sim->n + 2U; i++)
+    {
+        sim->succ_start[i] += sim->succ_start[i - 1U];
+    }
+    for (i = 0; i < edge_count; i++)
+    {
+        sim->succ[sim->succ_start[sim->edges[i].from + 1U]++] = sim->edges[i].to;
+    }
+
+    /* Kahn's algorithm, a node finishing its work after its latest
+     * predecessor and not before its pin */
+    for (i = 0; i < sim->n; i++)
+    {
+        sim->start[i] = sim->pin[i];
+        sim->crit[i] = NONE;
+        if (sim->indegree[i] == 0)
+        {
+            sim->queue[tail++] = i;
+        }
+    }
+
+    sim->end = NONE;
+    while (head < tail)
+    {
+        node = sim->queue[head++];
+        sim->finish[node] = sim->start[node] + sim->work[node];
+        if (sim->end == NONE || sim->finish[node] >= total)
+        {
+            total = sim->finish[node];
+            sim->end = node;
+        }
+
+        for (i = sim->succ_start[node]; i < sim->succ_start[node + 1U]; i++)
+        {
+            to = sim->succ[i];
+            if (sim->finish[node] >= sim->start[to])
+            {
+                sim->start[to] = sim->finish[node];
+                sim->crit[to] = node;
+            }
+            if (--sim->indegree[to] == 0)
+            {
+                sim->queue[tail++] = to;
+            }
+        }
+    }
+
+    return (tail == sim->n) ? total : UINT64_MAX;
+}
+
+/**
+ * Print the names along the critical path of the last replay
+ */
+static void print_path(const sim_t *sim)
+{
+    uint32_t length = 0;
+    uint32_t *path;
+    uint32_t node;
+    uint32_t i;
+
+    for (node = sim->end; node != NONE; node = sim->crit[node])
+    {
+        length++;
+    }
+
+    path = malloc((length + 1U) * sizeof(*path));
+    if (!path)
+    {
+        return;
+    }
+
+    i = length;
+    for (node = sim->end; node != NONE; node = sim->crit[node])
+    {
+        path[--i] = node;
+    }
+
+    printf("    ");
+    for (i = 0; i < length; i++)
+    {
+        /* Span begin and end records share a name, show it once */
+        if (i > 0 && sim->name_of[path[i]] == sim->name_of[path[i - 1U]])
+        {
+            continue;
+        }
+        printf("%s%s@cpu%" PRIu32, i ? " > " : "", sim->names[sim->name_of[path[i]]],
+               sim->cpu[path[i]]);
+    }
+    printf("\n");
+
+    free(path);
+}
+
+static change_t *config_add_change(config_t *config)
+{
+    change_t *grown;
+
+    if (config->change_count == config->change_capacity)
+    {
+        config->change_capacity = config->change_capacity ? 2U * config->change_capacity : 64U;
+        grown = realloc(config->changes, config->change_capacity * sizeof(*grown));
+        if (!grown)
+        {
+            return NULL;
+        }
+        config->changes = grown;
+    }
+
+    return &config->changes[config->change_count++];
+}
+
+static variant_t *config_add_variant(config_t *config, const char *label)
+{
+    variant_t *grown;
+    variant_t *variant;
+
+    if (config->variant_count == config->variant_capacity)
+    {
+        config->variant_capacity = config->variant_capacity ? 2U * config->variant_capacity : 16U;
+        grown = realloc(config->variants, config->variant_capacity * sizeof(*grown));
+        if (!grown)
+        {
+            return NULL;
+        }
+        config->variants = grown;
+    }
+
+    variant = &config->variants[config->variant_count++];
+    snprintf(variant->label, sizeof(variant->label), "%s", label);
+    variant->first_change = config->change_count;
+    variant->change_count = 0;
+
+    return variant;
+}
+
+/**
+ * Parse a config file against the names of a recorded boot
+ */
+static int config_load(config_t *config, const sim_t *sim, const char *path)
+{
+    char line[LINE_MAX_LEN];
+    char verb[16];
+    char name[BOOT_RECORD_NAME_LEN];
+    char other[BOOT_RECORD_NAME_LEN];
+    char label[LABEL_MAX_LEN];
+    variant_t *variant = NULL;
+    change_t *change;
+    double from;
+    double to;
+    unsigned steps;
+    unsigned line_no = 0;
+    unsigned i;
+    uint32_t name_index;
+    char *comment;
+    int fields;
+    FILE *file;
+
+    memset(config, 0, sizeof(*config));
+
+    file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file))
+    {
+        line_no++;
+        comment = strchr(line, '#');
+        if (comment)
+        {
+            *comment = '\0';
+        }
+
+        fields = sscanf(line, "%15s %23s %23s", verb, name, other);
+        if (fields <= 0)
+        {
+            continue;
+        }
+
+        if (strcmp(verb, "variant") == 0)
+        {
+            if (sscanf(line, "%*s %47[^\n]", label) != 1)
+            {
+                snprintf(label, sizeof(label), "variant %" PRIu32, config->variant_count + 1U);
+            }
+            variant = config_add_variant(config, label);
+            if (!variant)
+            {
+                goto no_memory;
+            }
+            continue;
+        }
+
+        name_index = (fields >= 2) ? find_name(sim, name) : NONE;
+        if (name_index == NONE)
+        {
+            fprintf(stderr, "%s:%u: %s\n", path, line_no,
+                    (fields >= 2) ? "no record of that name" : "missing name");
+            goto fail;
+        }
+
+        if (strcmp(verb, "sweep") == 0)
+        {
+            if (sscanf(line, "%*s %*s %lf %lf %u", &from, &to, &steps) != 3 ||
+                steps == 0)
+            {
+                fprintf(stderr, "%s:%u: expected sweep <name> <from> <to> <n>\n", path, line_no);
+                goto fail;
+            }
+
+            for (i = 0; i < steps; i++)
+            {
+                snprintf(label, sizeof(label), "%s x%.3g", name,
+                         (steps > 1U) ? from + (to - from) * i / (steps - 1U) : from);
+                if (!config_add_variant(config, label))
+                {
+                    goto no_memory;
+                }
+                change = config_add_change(config);
+                if (!change)
+                {
+                    goto no_memory;
+                }
+                change->type = CHANGE_SCALE;
+                change->name = name_index;
+                change->other = 0;
+                change->value = (steps > 1U) ? from + (to - from) * i / (steps - 1U) : from;
+                config->variants[config->variant_count - 1U].change_count = 1;
+            }
+            variant = NULL;
+            continue;
+        }
+
+        change = config_add_change(config);
+        if (!change)
+        {
+            goto no_memory;
+        }
+        change->name = name_index;
+        change->other = 0;
+        change->value = 0.0;
+
+        if (strcmp(verb, "scale") == 0 || strcmp(verb, "set") == 0)
+        {
+            change->type = (verb[1] == 'c') ? CHANGE_SCALE : CHANGE_SET;
+            if (fields != 3 || sscanf(other, "%lf", &change->value) != 1 ||
+                change->value < 0.0)
+            {
+                fprintf(stderr, "%s:%u: expected %s <name> <value>\n", path, line_no, verb);
+                goto fail;
+            }
+            if (change->type == CHANGE_SET)
+            {
+                change->value *= 1000.0;
+            }
+        }
+        else if (strcmp(verb, "move") == 0)
+        {
+            change->type = CHANGE_MOVE;
+            if (fields != 3 || sscanf(other, "%" SCNu32, &change->other) != 1 ||
+                change->other >= BOOT_RECORD_MAX_CPUS)
+            {
+                fprintf(stderr, "%s:%u: expected move <name> <cpu>\n", path, line_no);
+                goto fail;
+            }
+        }
+        else if (strcmp(verb, "after") == 0 || strcmp(verb, "drop") == 0)
+        {
+            change->type = (verb[0] == 'a') ? CHANGE_AFTER : CHANGE_DROP;
+            change->other = (fields == 3) ? find_name(sim, other) : NONE;
+            if (change->other == NONE)
+            {
+                fprintf(stderr, "%s:%u: no record of the name waited for\n", path, line_no);
+                goto fail;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "%s:%u: unknown change %s\n", path, line_no, verb);
+            goto fail;
+        }
+
+        if (variant)
+        {
+            variant->change_count++;
+        }
+        else if (config->variant_count == 0)
+        {
+            config->common_count++;
+        }
+        else
+        {
+            fprintf(stderr, "%s:%u: change after a sweep needs a variant\n", path, line_no);
+            goto fail;
+        }
+    }
+
+    fclose(file);
+    return 0;
+
+no_memory:
+    perror("malloc");
+fail:
+    fclose(file);
+    free(config->changes);
+    free(config->variants);
+    return -1;
+}
+
+static void print_result(const sim_t *sim, const char *label, uint64_t total,
+                         uint64_t recorded)
+{
+    if (total == UINT64_MAX)
+    {
+        printf("%-32s dependency cycle\n", label);
+        return;
+    }
+
+    printf("%-32s %12.3f ms %+12.3f ms %+8.1f%%\n", label, (double)total / 1e6,
+           ((double)total - (double)recorded) / 1e6,
+           recorded ? 100.0 * ((double)total - (double)recorded) / (double)recorded : 0.0);
+    print_path(sim);
+}
+
+static int bench_variants(sim_t *sim, const config_t *config)
+{
+    uint64_t runs = 0;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t i;
+
+    start = now_ns();
+    do
+    {
+        if (config->variant_count == 0)
+        {
+            sim_run(sim, config, NULL);
+            runs++;
+        }
+        for (i = 0; i < config->variant_count; i++)
+        {
+            sim_run(sim, config, &config->variants[i]);
+            runs++;
+        }
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+
+    printf("%" PRIu32 " records, %" PRIu64 " replays in %.3f s\n", sim->n, runs,
+           (double)elapsed / 1e9);
+    printf("%.0f variants/s\n", (double)runs * 1e9 / (double)elapsed);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    boot_record_status_t ret;
+    boot_record_dump_t dump;
+    boot_record_dag_t dag;
+    config_t config;
+    uint64_t recorded;
+    sim_t sim;
+    int bench = 0;
+    int status = 0;
+    int arg = 1;
+    uint32_t i;
+
+    if (arg < argc && strcmp(argv[arg], "-b") == 0)
+    {
+        bench = 1;
+        arg++;
+    }
+
+    if (argc - arg != 2)
+    {
+        fprintf(stderr, "usage: %s [-b] <dump.bin> <config>\n", argv[0]);
+        return 2;
+    }
+
+    if (boot_record_dump_open(&dump, argv[arg], 0, 0) != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", argv[arg], strerror(errno));
+        return 1;
+    }
+
+    ret = boot_record_dag_build(&dag, &dump);
+    if (ret != BOOT_RECORD_SUCCESS || dag.end == NONE)
+    {
+        fprintf(stderr, "%s: %s\n", argv[arg],
+                (ret == BOOT_RECORD_ERR_INSUFFICIENT_MEM) ? strerror(ENOMEM) :
+                (ret == BOOT_RECORD_SUCCESS) ? "no records" :
+                "not a valid boot record dump");
+        boot_record_dag_free(&dag);
+        boot_record_dump_close(&dump);
+        return 1;
+    }
+
+    if (sim_init(&sim, &dag) != 0)
+    {
+        perror("malloc");
+        status = 1;
+    }
+    else if (config_load(&config, &sim, argv[arg + 1]) != 0)
+    {
+        status = 1;
+    }
+    else
+    {
+        recorded = dag.nodes[dag.end].finish;
+
+        if (bench)
+        {
+            status = (bench_variants(&sim, &config) != 0);
+        }
+        else
+        {
+            print_result(&sim, "recorded", sim_run(&sim, NULL, NULL), recorded);
+            if (config.variant_count == 0)
+            {
+                print_result(&sim, "changed", sim_run(&sim, &config, NULL), recorded);
+            }
+            for (i = 0; i < config.variant_count; i++)
+            {
+                print_result(&sim, config.variants[i].label,
+                             sim_run(&sim, &config, &config.variants[i]), recorded);
+            }
+        }
+
+        free(config.changes);
+        free(config.variants);
+    }
+
+    sim_free(&sim);
+    boot_record_dag_free(&dag);
+    boot_record_dump_close(&dump);
+
+    return status;
+}
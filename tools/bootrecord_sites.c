@@ -0,0 +1,311 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_sites.c
+ * \brief Host tool printing boot record dumps with names from ELF images
+ *
+ * Usage: bootrecord_sites <image.elf>
+ *        bootrecord_sites <dump.bin> [<stage_id>=]<image.elf>...
+ *
+ * With a single image it lists the site table of the image, one site ID,
+ * call site and name per line. With a dump it prints every record like
+ * bootrecord_dump does, taking the names of BOOT_RECORD_FLAG_SITE_IDS stages
+ * from the image given for their stage ID, or from the image given without
+ * one. Records of other stages keep the names stored in the dump.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_elf.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/* Most images given on the command line, one per stage */
+#define MAX_IMAGES                          (BOOT_RECORD_MAX_STAGES)
+
+/* Stage ID of an image given without one */
+#define ANY_STAGE                           (0xFFFFFFFFU)
+
+/**
+ * Images of a dump and the stages they resolve
+ */
+typedef struct
+{
+    boot_record_elf_t elf[MAX_IMAGES];
+    uint32_t stage_id[MAX_IMAGES];
+    uint32_t count;
+} image_set_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Open an image and report why it can't be used
+ *
+ * \return 0 on success, -1 on failure
+ */
+static int open_image(boot_record_elf_t *elf, const char *path)
+{
+    boot_record_status_t status = boot_record_elf_open(elf, path);
+
+    if (status == BOOT_RECORD_ERR_INVALID_PARAMS)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    }
+    else if (status == BOOT_RECORD_ERR_FORMAT)
+    {
+        fprintf(stderr, "%s: not a linked ELF image with a valid %s section\n",
+                path, BOOT_RECORD_SITE_SECTION);
+    }
+    else if (status != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: out of memory\n", path);
+    }
+
+    return (status == BOOT_RECORD_SUCCESS) ? 0 : -1;
+}
+
+/**
+ * Print the site table of an image
+ */
+static void print_sites(const boot_record_elf_t *elf)
+{
+    uint32_t i;
+
+    for (i = 0; i < elf->count; i++)
+    {
+        printf("%5" PRIu32 "  %s:%" PRIu32 "  %s\n", i, elf->sites[i].file,
+               elf->sites[i].line, elf->sites[i].name);
+    }
+}
+
+/**
+ * Find the image resolving the site IDs of a stage
+ *
+ * \return Image, NULL if none was given for the stage
+ */
+static const boot_record_elf_t *find_image(const image_set_t *images,
+                                           uint32_t stage_id)
+{
+    const boot_record_elf_t *any = NULL;
+    uint32_t i;
+
+    for (i = 0; i < images->count; i++)
+    {
+        if (images->stage_id[i] == stage_id)
+        {
+            return &images->elf[i];
+        }
+        if (images->stage_id[i] == ANY_STAGE && !any)
+        {
+            any = &images->elf[i];
+        }
+    }
+
+    return any;
+}
+
+/**
+ * Print the header and the records of one validated boot stage
+ */
+static void print_stage(const boot_stage_record_t *stage,
+                        const image_set_t *images)
+{
+    const boot_record_elf_t *elf = NULL;
+    const boot_record_elf_site_t *site;
+    boot_record_record_iter_t iter;
+    boot_record_event_t event;
+    uint32_t count = boot_record_get_count(stage);
+    uint32_t cpu;
+
+    for (cpu = 0; cpu < stage->cpu_count; cpu++)
+    {
+        count += boot_record_get_count(boot_record_get_cpu_stage(stage, cpu));
+    }
+
+    if (stage->flags & BOOT_RECORD_FLAG_SITE_IDS)
+    {
+        elf = find_image(images, stage->record_id);
+    }
+
+    printf("stage %" PRIu32 ": %" PRIu32 " records, start %" PRIu64 " %s%s\n",
+           stage->record_id, count, stage->start_time,
+           stage->time_unit == BOOT_RECORD_TIME_TICKS ? "ticks" : "us",
+           ((stage->flags & BOOT_RECORD_FLAG_SITE_IDS) && !elf) ?
+           ", no image for its site IDs" : "");
+
+    boot_record_record_iter_init(&iter, stage);
+    while (boot_record_record_iter_next_event(&iter, &event))
+    {
+        printf("%20" PRIu64 "  cpu%-2" PRIu32 "  ", event.time, event.cpu_id);
+
+        site = elf ? boot_record_elf_site(elf, event.name_id) : NULL;
+        if (site)
+        {
+            printf("%s  (%s:%" PRIu32 ")\n", site->name, site->file, site->line);
+        }
+        else if (event.name)
+        {
+            printf("%.*s\n", (int)BOOT_RECORD_NAME_LEN - 1, event.name);
+        }
+        else
+        {
+            printf("#%" PRIu32 "\n", event.name_id);
+        }
+    }
+}
+
+/**
+ * Parse a [<stage_id>=]<image.elf> argument and open the image
+ *
+ * \return 0 on success, -1 on failure
+ */
+static int add_image(image_set_t *images, const char *arg)
+{
+    const char *path = arg;
+    const char *eq = strchr(arg, '=');
+    char *end;
+    unsigned long stage_id = ANY_STAGE;
+
+    if (images->count == MAX_IMAGES)
+    {
+        fprintf(stderr, "%s: more than %u images\n", arg, (unsigned)MAX_IMAGES);
+        return -1;
+    }
+
+    if (eq)
+    {
+        stage_id = strtoul(arg, &end, 0);
+        if (end != eq || end == arg || stage_id >= ANY_STAGE)
+        {
+            fprintf(stderr, "%s: invalid stage ID\n", arg);
+            return -1;
+        }
+        path = eq + 1;
+    }
+
+    if (open_image(&images->elf[images->count], path) != 0)
+    {
+        return -1;
+    }
+
+    images->stage_id[images->count++] = (uint32_t)stage_id;
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t iter;
+    boot_record_dump_t dump;
+    image_set_t *images;
+    int status = 0;
+    int arg;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <image.elf>\n"
+                "       %s <dump.bin> [<stage_id>=]<image.elf>...\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+
+    images = calloc(1, sizeof(*images));
+    if (!images)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    if (argc == 2)
+    {
+        if (open_image(&images->elf[0], argv[1]) != 0)
+        {
+            free(images);
+            return 1;
+        }
+
+        print_sites(&images->elf[0]);
+        boot_record_elf_close(&images->elf[0]);
+        free(images);
+        return 0;
+    }
+
+    for (arg = 2; arg < argc && status == 0; arg++)
+    {
+        status = add_image(images, argv[arg]);
+    }
+
+    if (status == 0)
+    {
+        if (boot_record_dump_open(&dump, argv[1], 0, 0) != BOOT_RECORD_SUCCESS)
+        {
+            fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+            status = -1;
+        }
+        else
+        {
+            boot_record_stage_iter_init(&iter, &dump);
+            while ((stage = boot_record_stage_iter_next(&iter)) != NULL)
+            {
+                print_stage(stage, images);
+            }
+
+            if (iter.status != BOOT_RECORD_SUCCESS)
+            {
+                fprintf(stderr, "%s: not a valid boot record dump\n", argv[1]);
+                status = -1;
+            }
+            boot_record_dump_close(&dump);
+        }
+    }
+
+    while (images->count)
+    {
+        boot_record_elf_close(&images->elf[--images->count]);
+    }
+    free(images);
+
+    return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,340 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_stats.c
+ * \brief Host tool reporting checkpoint-to-checkpoint percentiles of many boots
+ *
+ * Usage: bootrecord_stats [-j <threads>] [-b] <dump.bin|directory>...
+ *
+ * For every stage ID and pair of consecutive profile points of a CPU, prints
+ * how many durations between them were seen and their 50th, 95th and 99th
+ * percentiles in microseconds, within 1% relative error. Span begin and end
+ * records are labelled "name[" and "name]".
+ *
+ * Directories are searched recursively for dumps, which are read on a
+ * work-stealing pool of -j threads, one per online CPU by default. With -b
+ * it prints no statistics; it reads all dumps once with 1, 2, 4, ... up to
+ * -j threads and reports how the throughput scales.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_ingest.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Pairs of an aggregate collected for sorting
+ */
+typedef struct
+{
+    const boot_record_pair_t **pairs;
+    uint32_t count;
+} pair_list_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+static void collect_pair(const boot_record_pair_t *pair, void *arg)
+{
+    pair_list_t *list = arg;
+
+    list->pairs[list->count++] = pair;
+}
+
+static int compare_pairs(const void *a, const void *b)
+{
+    const boot_record_pair_t *pa = *(const boot_record_pair_t * const *)a;
+    const boot_record_pair_t *pb = *(const boot_record_pair_t * const *)b;
+    int diff;
+
+    if (pa->stage_id != pb->stage_id)
+    {
+        return (pa->stage_id < pb->stage_id) ? -1 : 1;
+    }
+
+    diff = strcmp(pa->from, pb->from);
+    if (diff == 0)
+    {
+        diff = strcmp(pa->to, pb->to);
+    }
+    if (diff == 0)
+    {
+        diff = (int)pa->from_kind - (int)pb->from_kind;
+    }
+    if (diff == 0)
+    {
+        diff = (int)pa->to_kind - (int)pb->to_kind;
+    }
+
+    return diff;
+}
+
+/* Label a profile point with its kind, "name[" for a span begin and
+ * "name]" for a span end */
+static const char *label(char *buf, size_t size, const char *name, uint8_t kind)
+{
+    snprintf(buf, size, "%s%s", name,
+             (kind == BOOT_RECORD_KIND_BEGIN) ? "[" :
+             (kind == BOOT_RECORD_KIND_END) ? "]" : "");
+    return buf;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void report_error(const char *path, boot_record_status_t status,
+                         int error, void *arg)
+{
+    (void)arg;
+
+    if (status == BOOT_RECORD_ERR_INVALID_PARAMS && error)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(error));
+    }
+    else
+    {
+        fprintf(stderr, "%s: not a valid boot record dump\n", path);
+    }
+}
+
+static int bench_ingest(const boot_record_path_list_t *list, uint32_t max_threads)
+{
+    boot_record_ingest_params_t params = { 0 };
+    boot_record_ingest_result_t result;
+    boot_record_agg_t agg;
+    uint64_t base_ns = 0;
+    uint64_t elapsed;
+    uint32_t threads = 1;
+
+    /* Untimed pass, so every run finds the files in the page cache */
+    params.threads = max_threads;
+    if (boot_record_agg_init(&agg, 0) != BOOT_RECORD_SUCCESS ||
+        boot_record_ingest(&agg, list->paths, list->count, &params, &result) != BOOT_RECORD_SUCCESS)
+    {
+        perror("malloc");
+        return -1;
+    }
+    boot_record_agg_free(&agg);
+
+    printf("%" PRIu32 " files, %" PRIu64 " bytes, %" PRIu32 " failed\n",
+           result.files + result.failed, result.bytes, result.failed);
+    printf("%8s %10s %12s %12s %8s\n", "threads", "ms", "files/s", "MB/s",
+           "speedup");
+
+    while (threads)
+    {
+        params.threads = threads;
+        boot_record_agg_init(&agg, 0);
+        elapsed = now_ns();
+        boot_record_ingest(&agg, list->paths, list->count, &params, &result);
+        elapsed = now_ns() - elapsed + 1U;
+        boot_record_agg_free(&agg);
+
+        if (threads == 1U)
+        {
+            base_ns = elapsed;
+        }
+
+        printf("%8" PRIu32 " %10.1f %12.0f %12.1f %8.2f\n", result.threads,
+               (double)elapsed / 1e6,
+               (double)(result.files + result.failed) * 1e9 / (double)elapsed,
+               (double)result.bytes * 1e3 / (double)elapsed,
+               (double)base_ns / (double)elapsed);
+
+        if (threads == max_threads)
+        {
+            break;
+        }
+        threads = (2U * threads < max_threads) ? 2U * threads : max_threads;
+    }
+
+    return 0;
+}
+
+static void print_agg(const boot_record_agg_t *agg)
+{
+    const boot_record_pair_t *pair;
+    char from[BOOT_RECORD_NAME_LEN + 1U];
+    char to[BOOT_RECORD_NAME_LEN + 1U];
+    pair_list_t list;
+    uint32_t i;
+
+    list.pairs = malloc((agg->pair_count + 1U) * sizeof(*list.pairs));
+    list.count = 0;
+    if (!list.pairs)
+    {
+        perror("malloc");
+        return;
+    }
+
+    boot_record_agg_foreach(agg, collect_pair, &list);
+    qsort(list.pairs, list.count, sizeof(*list.pairs), compare_pairs);
+
+    printf("%" PRIu64 " stages, %" PRIu32 " pairs\n", agg->stages, list.count);
+    printf("%-10s %-24s %-24s %10s %12s %12s %12s\n", "stage", "from", "to",
+           "count", "p50 us", "p95 us", "p99 us");
+
+    for (i = 0; i < list.count; i++)
+    {
+        pair = list.pairs[i];
+        printf("0x%08" PRIx32 " %-24s %-24s %10" PRIu64 " %12.3f %12.3f %12.3f\n",
+               pair->stage_id,
+               label(from, sizeof(from), pair->from, pair->from_kind),
+               label(to, sizeof(to), pair->to, pair->to_kind),
+               pair->sketch.count,
+               boot_record_sketch_quantile(&pair->sketch, 0.50) / 1000.0,
+               boot_record_sketch_quantile(&pair->sketch, 0.95) / 1000.0,
+               boot_record_sketch_quantile(&pair->sketch, 0.99) / 1000.0);
+    }
+
+    if (agg->dropped)
+    {
+        printf("%" PRIu64 " durations dropped, more than %" PRIu32 " pairs\n",
+               agg->dropped, agg->max_pairs);
+    }
+
+    if (agg->rejected)
+    {
+        printf("%" PRIu64 " stages skipped, tick rate not convertible\n",
+               agg->rejected);
+    }
+
+    free(list.pairs);
+}
+
+int main(int argc, char **argv)
+{
+    boot_record_ingest_params_t params = { 0 };
+    boot_record_ingest_result_t result;
+    boot_record_path_list_t list;
+    boot_record_agg_t agg;
+    boot_record_status_t ret;
+    long online;
+    int bench = 0;
+    int status = 0;
+    int arg = 1;
+
+    params.error_fn = report_error;
+
+    while (arg < argc && argv[arg][0] == '-')
+    {
+        if (strcmp(argv[arg], "-b") == 0)
+        {
+            bench = 1;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-j") == 0 && arg + 1 < argc)
+        {
+            params.threads = (uint32_t)strtoul(argv[arg + 1], NULL, 0);
+            arg += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (arg >= argc)
+    {
+        fprintf(stderr, "usage: %s [-j <threads>] [-b] <dump.bin|directory>...\n",
+                argv[0]);
+        return 2;
+    }
+
+    boot_record_path_list_init(&list);
+    for (; arg < argc; arg++)
+    {
+        ret = boot_record_path_list_add(&list, argv[arg]);
+        if (ret == BOOT_RECORD_ERR_INSUFFICIENT_MEM)
+        {
+            perror("malloc");
+            boot_record_path_list_free(&list);
+            return 1;
+        }
+        else if (ret != BOOT_RECORD_SUCCESS)
+        {
+            fprintf(stderr, "%s: %s\n", argv[arg], strerror(errno));
+            status = 1;
+        }
+    }
+
+    if (bench)
+    {
+        if (params.threads == 0U)
+        {
+            online = sysconf(_SC_NPROCESSORS_ONLN);
+            params.threads = (online > 0) ? (uint32_t)online : 1U;
+        }
+        status = (bench_ingest(&list, params.threads) != 0);
+        boot_record_path_list_free(&list);
+        return status;
+    }
+
+    if (boot_record_agg_init(&agg, 0) != BOOT_RECORD_SUCCESS ||
+        boot_record_ingest(&agg, list.paths, list.count, &params, &result) != BOOT_RECORD_SUCCESS)
+    {
+        perror("malloc");
+        boot_record_path_list_free(&list);
+        return 1;
+    }
+
+    if (result.failed)
+    {
+        status = 1;
+    }
+
+    print_agg(&agg);
+    boot_record_agg_free(&agg);
+    boot_record_path_list_free(&list);
+
+    return status;
+}
@@ -0,0 +1,319 @@
+/*
+ *  Copyright (C) 2025 Texas Instruments Incorporated
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ *    Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ *    Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file bootrecord_trace.c
+ * \brief Host tool exporting boot record dumps as Chrome trace-event JSON
+ *
+ * Usage: bootrecord_trace [-b] <dump.bin>... > trace.json
+ *
+ * The output loads in Perfetto (ui.perfetto.dev) and chrome://tracing. Each
+ * dump becomes a process and each stage, or each CPU of a per-CPU stage, a
+ * track of it. Span records become duration events and other profile
+ * points instant events. Events are written while the records are read, so
+ * memory use does not depend on the size of the dumps.
+ *
+ * With -b the trace goes to a temporary file, and the tool prints its size
+ * and how long it took to write, for comparison with bootrecord_perfetto -b.
+ */
+
+/* ========================================================================== */
+/*                           Include Files                                    */
+/* ========================================================================== */
+
+#include "bootrecord_reader.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* ========================================================================== */
+/*                           Macros & Typedefs                                */
+/* ========================================================================== */
+
+/**
+ * Output state shared by all dumps
+ */
+typedef struct
+{
+    FILE *out;
+    /* No event written yet, so the next one needs no separating comma */
+    int first;
+} trace_writer_t;
+
+/* ========================================================================== */
+/*                          Function Definitions                              */
+/* ========================================================================== */
+
+/**
+ * Write a string as a JSON string literal
+ */
+static void write_string(FILE *out, const char *s, size_t max_len)
+{
+    size_t i;
+
+    fputc('"', out);
+    for (i = 0; i < max_len && s[i] != '\0'; i++)
+    {
+        unsigned char c = (unsigned char)s[i];
+
+        if (c == '"' || c == '\\')
+        {
+            fputc('\\', out);
+            fputc(c, out);
+        }
+        else if (c < 0x20U || c >= 0x7FU)
+        {
+            /* Record names are ASCII, anything else is shown escaped */
+            fprintf(out, "\\u%04x", c);
+        }
+        else
+        {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+/**
+ * Start the next event object
+ */
+static void begin_event(trace_writer_t *writer)
+{
+    fputs(writer->first ? "\n" : ",\n", writer->out);
+    writer->first = 0;
+}
+
+/**
+ * Write a process_name or thread_name metadata event
+ */
+static void write_metadata(trace_writer_t *writer, const char *kind,
+                           uint32_t pid, uint32_t tid, const char *name)
+{
+    begin_event(writer);
+    fprintf(writer->out, "{\"ph\":\"M\",\"name\":\"%s\",\"pid\":%" PRIu32
+            ",\"tid\":%" PRIu32 ",\"args\":{\"name\":", kind, pid, tid);
+    write_string(writer->out, name, strlen(name));
+    fputs("}}", writer->out);
+}
+
+/**
+ * Write one record as a trace event
+ */
+static void write_event(trace_writer_t *writer, uint32_t pid, uint32_t tid,
+                        const boot_record_tconv_t *to_ns,
+                        const boot_record_event_t *event)
+{
+    uint64_t ns = boot_record_tconv_apply(to_ns, event->time);
+    char id_name[16];
+
+    /* An end record whose begin record was overwritten in ring mode */
+    if (event->kind == BOOT_RECORD_KIND_END &&
+        event->link == BOOT_RECORD_INDEX_NONE)
+    {
+        return;
+    }
+
+    begin_event(writer);
+    fprintf(writer->out, "{\"ph\":\"%s\",\"pid\":%" PRIu32 ",\"tid\":%" PRIu32
+            ",\"ts\":%" PRIu64 ".%03u",
+            event->kind == BOOT_RECORD_KIND_BEGIN ? "B" :
+            event->kind == BOOT_RECORD_KIND_END ? "E" : "i",
+            pid, tid, ns / 1000U, (unsigned int)(ns % 1000U));
+
+    if (event->kind == BOOT_RECORD_KIND_END)
+    {
+        fputs("}", writer->out);
+        return;
+    }
+
+    if (event->kind != BOOT_RECORD_KIND_BEGIN)
+    {
+        fputs(",\"s\":\"t\"", writer->out);
+    }
+
+    fputs(",\"name\":", writer->out);
+    if (event->name)
+    {
+        write_string(writer->out, event->name, BOOT_RECORD_NAME_LEN - 1U);
+    }
+    else
+    {
+        snprintf(id_name, sizeof(id_name), "#%" PRIu32, event->name_id);
+        write_string(writer->out, id_name, sizeof(id_name));
+    }
+    fputs("}", writer->out);
+}
+
+/**
+ * Write the tracks and events of one validated boot stage
+ *
+ * \param stage_index Position of the stage in its dump
+ */
+static void write_stage(trace_writer_t *writer, uint32_t pid,
+                        uint32_t stage_index, const boot_stage_record_t *stage)
+{
+    boot_record_record_iter_t iter;
+    boot_record_event_t event;
+    boot_record_tconv_t to_ns;
+    uint32_t tracks = (stage->flags & BOOT_RECORD_FLAG_PER_CPU) ?
+                      stage->cpu_count : 1U;
+    uint32_t tid = stage_index * BOOT_RECORD_MAX_CPUS + 1U;
+    uint32_t cpu;
+    char name[48];
+
+    for (cpu = 0; cpu < tracks; cpu++)
+    {
+        if (stage->flags & BOOT_RECORD_FLAG_PER_CPU)
+        {
+            snprintf(name, sizeof(name), "stage %" PRIu32 " cpu%" PRIu32,
+                     stage->record_id, cpu);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "stage %" PRIu32, stage->record_id);
+        }
+        write_metadata(writer, "thread_name", pid, tid + cpu, name);
+    }
+
+    boot_record_tconv_init(&to_ns, stage, BOOT_RECORD_UNIT_NS);
+
+    boot_record_record_iter_init(&iter, stage);
+    while (boot_record_record_iter_next_event(&iter, &event))
+    {
+        write_event(writer, pid, tid + event.cpu_id, &to_ns, &event);
+    }
+}
+
+/**
+ * Write every stage of one dump file as a process
+ *
+ * \return 0 on success, -1 if the dump can't be read or is invalid
+ */
+static int write_dump(trace_writer_t *writer, uint32_t pid, const char *path)
+{
+    const boot_stage_record_t *stage;
+    boot_record_stage_iter_t iter;
+    boot_record_dump_t dump;
+    uint32_t stage_index = 0;
+
+    if (boot_record_dump_open(&dump, path, 0, 0) != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    write_metadata(writer, "process_name", pid, 0, path);
+
+    boot_record_stage_iter_init(&iter, &dump);
+    while ((stage = boot_record_stage_iter_next(&iter)) != NULL)
+    {
+        write_stage(writer, pid, stage_index++, stage);
+    }
+
+    boot_record_dump_close(&dump);
+
+    if (iter.status != BOOT_RECORD_SUCCESS)
+    {
+        fprintf(stderr, "%s: not a valid boot record dump\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    trace_writer_t writer;
+    uint64_t elapsed;
+    int bench = 0;
+    int status = 0;
+    int first = 1;
+    int i;
+
+    if (argc > 1 && strcmp(argv[1], "-b") == 0)
+    {
+        bench = 1;
+        first = 2;
+    }
+
+    if (argc <= first)
+    {
+        fprintf(stderr, "usage: %s [-b] <dump.bin>... > trace.json\n", argv[0]);
+        return 2;
+    }
+
+    writer.out = bench ? tmpfile() : stdout;
+    writer.first = 1;
+    if (!writer.out)
+    {
+        perror("tmpfile");
+        return 1;
+    }
+
+    elapsed = now_ns();
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", writer.out);
+    for (i = first; i < argc; i++)
+    {
+        if (write_dump(&writer, (uint32_t)(i - first + 1), argv[i]) != 0)
+        {
+            status = 1;
+        }
+    }
+    fputs("\n]}\n", writer.out);
+
+    if (fflush(writer.out) != 0)
+    {
+        perror("write");
+        return 1;
+    }
+    elapsed = now_ns() - elapsed + 1U;
+
+    if (bench)
+    {
+        printf("json: %.1f MB in %.1f ms\n", (double)ftell(writer.out) / 1e6,
+               (double)elapsed / 1e6);
+        fclose(writer.out);
+    }
+
+    return status;
+}